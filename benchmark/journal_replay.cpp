@@ -0,0 +1,94 @@
+// Cost of recording emissions into a journal, and replay of the recorded
+// traffic through a queued connection.
+//
+// A few threads emit bursts separated by pauses, as a stand-in for production
+// traffic, with a recorder attached. The journal is then replayed as fast as
+// possible and at the original pace into a signal delivering to a queue.
+// A journal recorded elsewhere can be replayed by passing its path.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "../signal-slot/core/task_queue.hpp"
+
+namespace {
+
+struct Order {
+    std::uint64_t id;
+    double price;
+    std::uint32_t quantity;
+};
+
+using clock_type = std::chrono::steady_clock;
+
+double ns_per(clock_type::duration d, std::uint64_t n) {
+    return n ? std::chrono::duration<double, std::nano>(d).count() / static_cast<double>(n) : 0;
+}
+
+void record(const std::string& path, int threads, int bursts, int burst_size) {
+    sigslot::journal_recorder<Order, std::string> recorder(path);
+    sigslot::signal<Order, std::string> sig;
+    recorder.attach(sig);
+
+    std::vector<std::thread> workers;
+    std::atomic<std::int64_t> busy{0};
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            const std::string symbol = "SYM" + std::to_string(t);
+            for (int b = 0; b < bursts; ++b) {
+                const auto start = clock_type::now();
+                for (int i = 0; i < burst_size; ++i) {
+                    sig(Order{static_cast<std::uint64_t>(i), 100.0 + i, 10}, symbol);
+                }
+                busy += (clock_type::now() - start).count();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    std::printf("recorded %llu emissions, %llu dropped, %.1f ns per emission\n",
+                static_cast<unsigned long long>(recorder.records()),
+                static_cast<unsigned long long>(recorder.dropped()),
+                ns_per(clock_type::duration(busy.load()), recorder.records()));
+}
+
+void replay(const std::string& path, double speed) {
+    sigslot::journal_replayer<Order, std::string> replayer(path);
+    auto queue = core::TaskQueue::Create("consumer");
+    std::atomic<std::size_t> received{0};
+    sigslot::signal<Order, std::string> sig;
+    sig.connect([&received](const Order&, const std::string&) { ++received; },
+                sigslot::connection_type::queued_connection, queue.get());
+
+    const auto start = clock_type::now();
+    const auto n = replayer.replay(sig, speed);
+    while (received != n) {
+        std::this_thread::yield();
+    }
+    const auto elapsed = clock_type::now() - start;
+    std::printf("replay speed %-4g %zu emissions in %8.2f ms (recorded span %8.2f ms)\n", speed, n,
+                std::chrono::duration<double, std::milli>(elapsed).count(),
+                std::chrono::duration<double, std::milli>(replayer.span()).count());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string path;
+    if (argc > 1) {
+        path = argv[1];
+    } else {
+        path = "bench_journal";
+        record(path, 4, 50, 2000);
+    }
+    replay(path, 0);
+    replay(path, 1);
+    return 0;
+}
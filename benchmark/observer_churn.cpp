@@ -0,0 +1,88 @@
+// Memory benchmark for observers that connect and disconnect repeatedly.
+//
+// A long-lived observer subscribes to a set of signals and keeps dropping and
+// re-creating its connections from the outside. The number of live heap blocks
+// and the time of disconnect_all() must stay flat as the churn goes on.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+
+namespace {
+
+std::atomic<long> g_live_blocks{0};
+
+struct Observer : sigslot::observer {
+    using sigslot::observer::connection_count;
+    using sigslot::observer::disconnect_all;
+    void onValue(int v) { sum += v; }
+    long sum = 0;
+};
+
+double elapsed_us(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void *p = std::malloc(size ? size : 1)) {
+        ++g_live_blocks;
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    if (p) {
+        --g_live_blocks;
+        std::free(p);
+    }
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+int main(int argc, char **argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 10;
+    const int churn = argc > 2 ? std::atoi(argv[2]) : 100000;
+    constexpr int kSignals = 16;
+    constexpr int kPersistent = 4;
+
+    std::vector<sigslot::signal<int>> signals(kSignals);
+    Observer observer;
+    for (int i = 0; i < kPersistent; ++i) {
+        signals[i].connect(&observer, &Observer::onValue);
+    }
+
+    std::printf("%6s %12s %14s %12s %16s\n",
+                "round", "live conns", "heap blocks", "ns/churn", "disconnect_all us");
+    for (int r = 0; r < rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < churn; ++i) {
+            auto conn = signals[i % kSignals].connect(&observer, &Observer::onValue);
+            signals[i % kSignals](1);
+            conn.disconnect();
+        }
+        const double churn_ns = elapsed_us(start) * 1000.0 / churn;
+
+        // measure the cost of disconnect_all on a copy of the steady state
+        Observer probe;
+        for (int i = 0; i < kPersistent; ++i) {
+            signals[i].connect(&probe, &Observer::onValue);
+        }
+        start = std::chrono::steady_clock::now();
+        probe.disconnect_all();
+        const double disconnect_us = elapsed_us(start);
+
+        std::printf("%6d %12zu %14ld %12.1f %16.2f\n", r, observer.connection_count(),
+                    g_live_blocks.load(), churn_ns, disconnect_us);
+    }
+
+    return observer.sum > 0 ? 0 : 1;
+}
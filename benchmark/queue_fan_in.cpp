@@ -0,0 +1,76 @@
+// Fan-in benchmark: many producer threads posting into a single task queue.
+//
+// Compares the default backend, a single locked inbox, with the sharded one,
+// per-producer inboxes, from one producer up to one per hardware thread.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../signal-slot/core/task_queue.hpp"
+
+namespace {
+
+using QueueFactory = std::function<std::unique_ptr<core::TaskQueue>()>;
+
+// returns the number of tasks run per second
+double run(const QueueFactory& factory, unsigned producers, int tasks_per_producer) {
+    auto queue = factory();
+    std::atomic<long> executed{0};
+    const long total = static_cast<long>(producers) * tasks_per_producer;
+    std::promise<void> done;
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&]() {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < tasks_per_producer; ++i) {
+                queue->PostTask([&executed, &done, total]() {
+                    if (++executed == total) {
+                        done.set_value();
+                    }
+                });
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    done.get_future().wait();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return total / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int tasks = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    const QueueFactory stdlib = []() { return core::TaskQueue::Create("stdlib"); };
+    const QueueFactory sharded = []() { return core::TaskQueue::CreateSharded("sharded"); };
+
+    std::printf("%10s %16s %16s\n", "producers", "stdlib tasks/s", "sharded tasks/s");
+    for (unsigned producers = 1;; producers *= 2) {
+        producers = std::min(producers, cores);
+        std::printf("%10u %16.0f %16.0f\n", producers,
+                    run(stdlib, producers, tasks / producers),
+                    run(sharded, producers, tasks / producers));
+        if (producers == cores) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Throughput and latency of remote_sender / remote_receiver over a Unix
+// socketpair, compared with an in-process queued connection.
+//
+// Throughput: a burst of emissions is sent and timed until the last one is
+// received, the number of writes shows how well they were batched.
+// Latency: one emission at a time, waiting for it to be received.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "../signal-slot/core/task_queue.hpp"
+
+#if defined(__linux__)
+
+namespace {
+
+struct Quote {
+    std::uint64_t seq;
+    double price;
+    std::uint32_t size;
+};
+
+using clock_type = std::chrono::steady_clock;
+
+void wait_for(const std::atomic<std::uint64_t>& received, std::uint64_t count) {
+    while (received.load(std::memory_order_acquire) != count) {
+        std::this_thread::yield();
+    }
+}
+
+void report(const char *name, int count, clock_type::duration elapsed, std::vector<double>& latencies) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&latencies](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    std::printf("%-10s %10.0f msg/s   latency us  p50 %7.2f  p99 %7.2f  max %8.2f\n",
+                name, count / seconds, pct(0.5), pct(0.99), latencies.back());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 10000;
+
+    // remote bridge
+    {
+        int fds[2];
+        if (!core::UnixSocketPair(fds)) {
+            std::fprintf(stderr, "cannot create socket pair\n");
+            return 1;
+        }
+        auto writer = core::TaskQueue::Create("writer");
+        auto reader = core::TaskQueue::CreateEpoll("reader");
+        sigslot::remote_sender<Quote> sender(fds[0], writer.get());
+        sigslot::remote_receiver<Quote> receiver(fds[1], reader.get());
+
+        std::atomic<std::uint64_t> received{0};
+        receiver.connect([&received](const Quote& q) { received.store(q.seq + 1, std::memory_order_release); });
+
+        const auto start = clock_type::now();
+        for (int i = 0; i < count; ++i) {
+            sender(Quote{static_cast<std::uint64_t>(i), 1.0, 100});
+        }
+        wait_for(received, count);
+        const auto elapsed = clock_type::now() - start;
+        const auto writes = sender.writes();
+
+        std::vector<double> latencies;
+        latencies.reserve(rounds);
+        for (int i = count; i < count + rounds; ++i) {
+            const auto t = clock_type::now();
+            sender(Quote{static_cast<std::uint64_t>(i), 1.0, 100});
+            wait_for(received, i + 1);
+            latencies.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - t).count());
+        }
+        report("remote", count, elapsed, latencies);
+        std::printf("           %d emissions in %llu writes\n", count, static_cast<unsigned long long>(writes));
+    }
+
+    // in-process queued connection
+    {
+        auto queue = core::TaskQueue::Create("local");
+        sigslot::signal<Quote> sig;
+        std::atomic<std::uint64_t> received{0};
+        sig.connect([&received](const Quote& q) { received.store(q.seq + 1, std::memory_order_release); },
+                    sigslot::connection_type::queued_connection, queue.get());
+
+        const auto start = clock_type::now();
+        for (int i = 0; i < count; ++i) {
+            sig(Quote{static_cast<std::uint64_t>(i), 1.0, 100});
+        }
+        wait_for(received, count);
+        const auto elapsed = clock_type::now() - start;
+
+        std::vector<double> latencies;
+        latencies.reserve(rounds);
+        for (int i = count; i < count + rounds; ++i) {
+            const auto t = clock_type::now();
+            sig(Quote{static_cast<std::uint64_t>(i), 1.0, 100});
+            wait_for(received, i + 1);
+            latencies.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - t).count());
+        }
+        report("queued", count, elapsed, latencies);
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    std::printf("remote_bridge needs Linux\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,106 @@
+// Latency benchmark of shm_signal between two local processes.
+//
+// The parent emits a sequence number on a "ping" segment, a forked child echoes
+// it back on a "pong" segment, and the parent measures the round trip. Half of
+// it approximates the one way latency, futex wakeups included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "../signal-slot/core/task_queue.hpp"
+
+#if defined(CORE_POSIX)
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+using ping_signal = sigslot::shm_signal<std::uint64_t>;
+
+int child(const std::string& ping_name, const std::string& pong_name, int rounds) {
+    std::unique_ptr<ping_signal> pong;
+    for (int i = 0; i < 1000 && !pong; ++i) {
+        pong = ping_signal::open(pong_name);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto ping = ping_signal::open(ping_name);
+    if (!ping || !pong) {
+        return 1;
+    }
+
+    auto queue = core::TaskQueue::Create("echo");
+    std::atomic<int> echoed{0};
+    ping->connect([&](std::uint64_t seq) {
+        (*pong)(seq);
+        ++echoed;
+    });
+    ping->start(queue.get());
+    while (echoed < rounds) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ping->stop();
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const std::string ping_name = "sigslot_bench_ping_" + std::to_string(getpid());
+    const std::string pong_name = "sigslot_bench_pong_" + std::to_string(getpid());
+
+    auto ping = ping_signal::create(ping_name, 1024);
+    if (!ping) {
+        std::fprintf(stderr, "cannot create shared memory segment\n");
+        return 1;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(child(ping_name, pong_name, rounds));
+    }
+
+    auto pong = ping_signal::create(pong_name, 1024);
+    auto queue = core::TaskQueue::Create("measure");
+    std::atomic<std::uint64_t> received{0};
+    pong->connect([&received](std::uint64_t seq) { received.store(seq + 1, std::memory_order_release); });
+    pong->start(queue.get());
+
+    std::vector<double> latencies;
+    latencies.reserve(rounds);
+    for (int i = 0; i < rounds; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        (*ping)(static_cast<std::uint64_t>(i));
+        while (received.load(std::memory_order_acquire) != static_cast<std::uint64_t>(i) + 1) {
+            std::this_thread::yield();
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    pong->stop();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&latencies](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    std::printf("round trips: %d\n", rounds);
+    std::printf("round trip us  p50 %8.2f  p99 %8.2f  p99.9 %8.2f  max %8.2f\n",
+                pct(0.5), pct(0.99), pct(0.999), latencies.back());
+    std::printf("one way us     p50 %8.2f\n", pct(0.5) / 2);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+#else
+
+int main() {
+    std::printf("shm_signal needs a POSIX system\n");
+    return 0;
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <thread>
 #include "./signal-slot/signal_slot_api.hpp"
 #include "./signal-slot/core/task_queue_manager.hpp"
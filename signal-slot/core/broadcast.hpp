@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "signal.hpp"
+
+namespace sigslot {
+
+    namespace detail {
+
+        /*
+         * Shared state of a broadcast_channel, kept alive by the drain tasks
+         * pending in the consumer queues.
+         */
+        template <typename... T>
+        class broadcast_state : public std::enable_shared_from_this<broadcast_state<T...>> {
+            using args_type = std::tuple<std::decay_t<T>...>;
+            static constexpr std::size_t cache_line = 64;
+
+        public:
+            struct consumer {
+                consumer(std::size_t i, core::TaskQueue *q, std::function<void(const std::decay_t<T>&...)> f, std::uint64_t start)
+                : id(i), queue(q), fn(std::move(f)), cursor(start)
+                {}
+
+                const std::size_t id;
+                core::TaskQueue *const queue;
+                const std::function<void(const std::decay_t<T>&...)> fn;
+                alignas(cache_line) std::atomic<std::uint64_t> cursor;  // next sequence to read
+                std::atomic<bool> scheduled{false};
+                std::atomic<bool> active{true};
+            };
+
+            using consumer_ptr = std::shared_ptr<consumer>;
+            using consumers_type = std::vector<consumer_ptr>;
+
+            explicit broadcast_state(std::size_t capacity)
+            : m_mask(round_up(capacity) - 1)
+            , m_ring(m_mask + 1)
+            {}
+
+            std::size_t capacity() const noexcept {
+                return m_mask + 1;
+            }
+
+            std::size_t add(core::TaskQueue *queue, std::function<void(const std::decay_t<T>&...)> fn) {
+                std::lock_guard<spin_mutex> _{m_mutex};
+                const std::size_t id = ++m_last_id;
+                auto c = std::make_shared<consumer>(id, queue, std::move(fn), m_published.load(std::memory_order_acquire));
+                auto consumers = std::make_shared<consumers_type>(*m_consumers);
+                consumers->push_back(std::move(c));
+                m_consumers = std::move(consumers);
+                m_version.fetch_add(1, std::memory_order_release);
+                return id;
+            }
+
+            bool remove(std::size_t id) {
+                std::lock_guard<spin_mutex> _{m_mutex};
+                auto consumers = std::make_shared<consumers_type>(*m_consumers);
+                auto it = std::find_if(consumers->begin(), consumers->end(), [id](const auto& c) {
+                    return c->id == id;
+                });
+                if (it == consumers->end()) {
+                    return false;
+                }
+                (*it)->active = false;
+                consumers->erase(it);
+                m_consumers = std::move(consumers);
+                m_version.fetch_add(1, std::memory_order_release);
+                return true;
+            }
+
+            void remove_all() {
+                std::lock_guard<spin_mutex> _{m_mutex};
+                for (auto& c : *m_consumers) {
+                    c->active = false;
+                }
+                m_consumers = std::make_shared<consumers_type>();
+                m_version.fetch_add(1, std::memory_order_release);
+            }
+
+            std::size_t consumer_count() const {
+                std::lock_guard<spin_mutex> _{m_mutex};
+                return m_consumers->size();
+            }
+
+            // number of events published but not yet read by the slowest consumer
+            std::size_t backlog() const {
+                std::shared_ptr<const consumers_type> consumers;
+                {
+                    std::lock_guard<spin_mutex> _{m_mutex};
+                    consumers = m_consumers;
+                }
+                const auto published = m_published.load(std::memory_order_acquire);
+                return static_cast<std::size_t>(published - min_cursor(*consumers, published));
+            }
+
+            // producer side, returns false if the ring is full and wait is false
+            template <typename... U>
+            bool publish(bool wait, U&& ...u) {
+                refresh();
+                const auto seq = m_published.load(std::memory_order_relaxed);
+
+                // the slot to write must have been read by every consumer
+                while (seq - m_gate >= capacity()) {
+                    m_gate = min_cursor(*m_snapshot, seq);
+                    if (seq - m_gate < capacity()) {
+                        break;
+                    }
+                    if (!wait) {
+                        return false;
+                    }
+                    std::this_thread::yield();
+                    refresh();
+                }
+
+                m_ring[seq & m_mask].emplace(std::forward<U>(u)...);
+                m_published.store(seq + 1, std::memory_order_release);
+
+                for (auto& c : *m_snapshot) {
+                    if (!c->scheduled.exchange(true)) {
+                        schedule(c);
+                    }
+                }
+                return true;
+            }
+
+            // producer side for the slots of attached signals, which may be
+            // emitted from several threads
+            template <typename... U>
+            void publish_serialized(U&& ...u) {
+                std::lock_guard<std::mutex> _{m_producer_mutex};
+                publish(true, std::forward<U>(u)...);
+            }
+
+        private:
+            static std::size_t round_up(std::size_t n) noexcept {
+                std::size_t c = 2;
+                while (c < n) {
+                    c <<= 1;
+                }
+                return c;
+            }
+
+            static std::uint64_t min_cursor(const consumers_type& consumers, std::uint64_t published) noexcept {
+                std::uint64_t min = published;
+                for (auto& c : consumers) {
+                    min = std::min(min, c->cursor.load(std::memory_order_acquire));
+                }
+                return min;
+            }
+
+            // reload the consumer list of the producer if it changed
+            void refresh() {
+                const auto version = m_version.load(std::memory_order_acquire);
+                if (version != m_snapshot_version || !m_snapshot) {
+                    std::lock_guard<spin_mutex> _{m_mutex};
+                    m_snapshot = m_consumers;
+                    m_snapshot_version = m_version.load(std::memory_order_relaxed);
+                }
+            }
+
+            void schedule(const consumer_ptr& c) {
+                c->queue->PostTask([self = this->shared_from_this(), c]() {
+                    self->drain(*c);
+                });
+            }
+
+            // consumer side, runs on the consumer queue
+            void drain(consumer& c) {
+                do {
+                    auto cursor = c.cursor.load(std::memory_order_relaxed);
+                    const auto published = m_published.load(std::memory_order_acquire);
+                    for (; cursor != published && c.active.load(std::memory_order_relaxed); ++cursor) {
+                        std::apply(c.fn, *m_ring[cursor & m_mask]);
+                    }
+                    c.cursor.store(published, std::memory_order_release);
+                    c.scheduled.store(false);
+                } while (c.active.load(std::memory_order_relaxed) &&
+                         c.cursor.load(std::memory_order_relaxed) != m_published.load(std::memory_order_acquire) &&
+                         !c.scheduled.exchange(true));
+            }
+
+        private:
+            const std::size_t m_mask;
+            std::vector<std::optional<args_type>> m_ring;
+
+            mutable spin_mutex m_mutex;
+            std::shared_ptr<const consumers_type> m_consumers = std::make_shared<consumers_type>();
+            std::size_t m_last_id = 0;
+            std::atomic<std::uint64_t> m_version{0};
+
+            // producer state
+            std::mutex m_producer_mutex;
+            alignas(cache_line) std::atomic<std::uint64_t> m_published{0};
+            std::uint64_t m_gate = 0;
+            std::shared_ptr<const consumers_type> m_snapshot;
+            std::uint64_t m_snapshot_version = 0;
+        };
+
+    } // namespace detail
+
+    /**
+     * broadcast_channel delivers the events of a single producer to several
+     * consumers, each on its own task queue, through one pre-allocated ring.
+     *      * The producer writes each event once in the ring, and every consumer reads it
+     * from there with its own cursor, in batches on its queue. Compared with one
+     * queued connection per consumer, an event costs one copy instead of one copy
+     * and one task per consumer.
+     *      * The ring is bounded: a slot is only reused once every consumer read it,
+     * so the slowest consumer applies backpressure to the producer, which waits
+     * in publish() or gets false from try_publish(). The producer must thus not
+     * run on a consumer queue. New consumers only see the events published after
+     * they subscribed.
+     *      * Events must be published from one thread at a time, except through
+     * attached signals which serialize their emissions.
+     *      * @tparam T... the argument types of the events
+     */
+    template <typename... T>
+    class broadcast_channel {
+        using state_type = detail::broadcast_state<T...>;
+
+    public:
+        /**
+         * @param capacity the number of events the ring holds, rounded up to a
+         *                 power of two
+         */
+        explicit broadcast_channel(std::size_t capacity)
+        : m_state(std::make_shared<state_type>(capacity))
+        {}
+
+        ~broadcast_channel() {
+            m_state->remove_all();
+        }
+
+        broadcast_channel(const broadcast_channel&) = delete;
+        broadcast_channel& operator=(const broadcast_channel&) = delete;
+
+        /**
+         * Publish an event, waiting for the slowest consumer if the ring is full
+         */
+        template <typename... U>
+        void publish(U&& ...u) {
+            m_state->publish(true, std::forward<U>(u)...);
+        }
+
+        /**
+         * Publish an event if the ring is not full
+         *          * @return false if the event was dropped
+         */
+        template <typename... U>
+        bool try_publish(U&& ...u) {
+            return m_state->publish(false, std::forward<U>(u)...);
+        }
+
+        template <typename... U>
+        void operator()(U&& ...u) {
+            publish(std::forward<U>(u)...);
+        }
+
+        /**
+         * Add a consumer called on queue for each event published from now on
+         *          * @return an identifier to use with unsubscribe
+         */
+        template <typename Callable>
+        std::size_t subscribe(core::TaskQueue *queue, Callable&& c) {
+            assert(queue);
+            return m_state->add(queue, std::forward<Callable>(c));
+        }
+
+        /**
+         * Remove a consumer, it is not called once this returns on its queue
+         */
+        bool unsubscribe(std::size_t id) {
+            return m_state->remove(id);
+        }
+
+        /**
+         * Publish the emissions of a signal. The emissions of the attached
+         * signals are serialized by a mutex, so they may be emitted from several
+         * threads, but must not race with publish() or try_publish().
+         */
+        template <typename Lockable>
+        connection attach(signal_base<Lockable, T...>& sig) {
+            return sig.connect([state = m_state](const std::decay_t<T>& ...a) {
+                state->publish_serialized(a...);
+            });
+        }
+
+        std::size_t capacity() const noexcept {
+            return m_state->capacity();
+        }
+
+        std::size_t consumer_count() const {
+            return m_state->consumer_count();
+        }
+
+        /**
+         * Number of events the slowest consumer has yet to read
+         */
+        std::size_t backlog() const {
+            return m_state->backlog();
+        }
+
+    private:
+        std::shared_ptr<state_type> m_state;
+    };
+
+} // namespace sigslot
@@ -0,0 +1,49 @@
+#include "clock.hpp"
+
+#if defined(CORE_POSIX)
+#include <time.h>
+#elif defined(CORE_WIN)
+#include <windows.h>
+#endif
+
+namespace core {
+
+    namespace {
+
+        class RealClock final : public Clock {
+        public:
+            TimePoint Now() const override {
+                return std::chrono::steady_clock::now();
+            }
+        };
+
+    }  // namespace
+
+    Clock& Clock::Real() {
+        static RealClock clock;
+        return clock;
+    }
+
+    std::chrono::nanoseconds ThreadCpuTime() {
+#if defined(CORE_POSIX)
+        struct timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#elif defined(CORE_WIN)
+        FILETIME creation, exit, kernel, user;
+        if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+            return std::chrono::nanoseconds(0);
+        }
+        // 100 nanoseconds units
+        auto ticks = [](const FILETIME& t) {
+            return (static_cast<long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+        };
+        return std::chrono::nanoseconds((ticks(kernel) + ticks(user)) * 100);
+#else
+        return std::chrono::nanoseconds(0);
+#endif
+    }
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+
+namespace core {
+
+    // Source of the current time of a task queue, and of the timers built on
+    // its delayed tasks, such as rate limited connections. Queues running on a
+    // thread use the real clock, TaskQueueSimulated uses a SimulatedClock.
+    class Clock {
+    public:
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        virtual ~Clock() = default;
+
+        virtual TimePoint Now() const = 0;
+
+        // The clock of std::chrono::steady_clock.
+        static Clock& Real();
+    };
+
+    // CPU time consumed by the calling thread, which unlike the wall clock does
+    // not advance while the thread is preempted or blocked. Uses
+    // CLOCK_THREAD_CPUTIME_ID on POSIX systems and GetThreadTimes on Windows,
+    // returns zero elsewhere.
+    std::chrono::nanoseconds ThreadCpuTime();
+
+}
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sigslot {
+
+    /**
+     * Read only view over trivially copyable values stored back to back in a
+     * byte buffer, as decoded from an encoded std::vector. The buffer has no
+     * alignment guarantee, values are copied out one at a time.
+     */
+    template <typename T>
+    class packed_view {
+        static_assert(std::is_trivially_copyable_v<T>, "packed_view holds trivially copyable values");
+
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = T;
+
+            iterator() = default;
+            explicit iterator(const unsigned char *p) noexcept : m_p(p) {}
+
+            T operator*() const noexcept {
+                T v;
+                std::memcpy(&v, m_p, sizeof(T));
+                return v;
+            }
+
+            iterator& operator++() noexcept { m_p += sizeof(T); return *this; }
+            iterator operator++(int) noexcept { auto it = *this; m_p += sizeof(T); return it; }
+            bool operator==(const iterator& o) const noexcept { return m_p == o.m_p; }
+            bool operator!=(const iterator& o) const noexcept { return m_p != o.m_p; }
+
+        private:
+            const unsigned char *m_p = nullptr;
+        };
+
+        packed_view() = default;
+        packed_view(const unsigned char *data, std::size_t count) noexcept
+        : m_data(data), m_count(count)
+        {}
+
+        std::size_t size() const noexcept { return m_count; }
+        bool empty() const noexcept { return m_count == 0; }
+        const unsigned char* bytes() const noexcept { return m_data; }
+
+        T operator[](std::size_t i) const noexcept {
+            assert(i < m_count);
+            return *iterator(m_data + i * sizeof(T));
+        }
+
+        iterator begin() const noexcept { return iterator(m_data); }
+        iterator end() const noexcept { return iterator(m_data + m_count * sizeof(T)); }
+
+        template <typename A = std::allocator<T>>
+        std::vector<T, A> to_vector() const {
+            std::vector<T, A> v(m_count);
+            if (m_count) {
+                std::memcpy(v.data(), m_data, m_count * sizeof(T));
+            }
+            return v;
+        }
+
+    private:
+        const unsigned char *m_data = nullptr;
+        std::size_t m_count = 0;
+    };
+
+    /**
+     * Customization point describing how a type is encoded in a byte buffer,
+     * specialize it for user types. A specialization provides:
+     *
+     *   using view_type = ...;       // what decoding yields, may point into the buffer
+     *   static std::size_t size(const T&);
+     *   static unsigned char* encode(unsigned char *p, const T&);  // returns p + size
+     *   static bool decode(const unsigned char *&p, const unsigned char *end, view_type&);
+     *   static T load(const view_type&);   // the value a slot taking T receives
+     *
+     * and optionally static constexpr std::size_t fixed_size when every value
+     * encodes on the same number of bytes. decode advances p and returns false
+     * on malformed or truncated input, it must never read past end.
+     *
+     * Trivially copyable types are copied bytewise, std::string and std::vector
+     * are prefixed with their 32 bits length.
+     */
+    template <typename T, typename = void>
+    struct codec_traits;
+
+    template <typename T>
+    struct codec_traits<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+        using view_type = T;
+        static constexpr std::size_t fixed_size = sizeof(T);
+
+        static constexpr std::size_t size(const T&) noexcept {
+            return sizeof(T);
+        }
+
+        static unsigned char* encode(unsigned char *p, const T& v) noexcept {
+            std::memcpy(p, &v, sizeof(T));
+            return p + sizeof(T);
+        }
+
+        static bool decode(const unsigned char *&p, const unsigned char *end, T& v) noexcept {
+            if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+
+        static const T& load(const T& v) noexcept {
+            return v;
+        }
+    };
+
+    namespace detail {
+
+        using codec_length = std::uint32_t;
+
+        inline unsigned char* encode_length(unsigned char *p, std::size_t n) noexcept {
+            assert(n <= std::numeric_limits<codec_length>::max());
+            const auto length = static_cast<codec_length>(n);
+            std::memcpy(p, &length, sizeof(length));
+            return p + sizeof(length);
+        }
+
+        // read a length prefix and check count elements of size bytes follow
+        inline bool decode_length(const unsigned char *&p, const unsigned char *end,
+                                  std::size_t size, std::size_t& count) noexcept {
+            codec_length length;
+            if (static_cast<std::size_t>(end - p) < sizeof(length)) {
+                return false;
+            }
+            std::memcpy(&length, p, sizeof(length));
+            p += sizeof(length);
+            count = length;
+            return size == 0 || static_cast<std::size_t>(end - p) / size >= count;
+        }
+
+        // characters are decoded as views into the buffer
+        template <typename S>
+        struct string_codec {
+            using view_type = std::string_view;
+
+            static std::size_t size(const S& s) noexcept {
+                return sizeof(codec_length) + s.size();
+            }
+
+            static unsigned char* encode(unsigned char *p, const S& s) noexcept {
+                p = encode_length(p, s.size());
+                if (!s.empty()) {
+                    std::memcpy(p, s.data(), s.size());
+                }
+                return p + s.size();
+            }
+
+            static bool decode(const unsigned char *&p, const unsigned char *end, std::string_view& v) noexcept {
+                std::size_t count;
+                if (!decode_length(p, end, 1, count)) {
+                    return false;
+                }
+                v = std::string_view(reinterpret_cast<const char*>(p), count);
+                p += count;
+                return true;
+            }
+
+            static S load(std::string_view v) {
+                return S(v);
+            }
+        };
+
+        template <typename T, typename = void>
+        struct has_fixed_size : std::false_type {};
+
+        template <typename T>
+        struct has_fixed_size<T, std::void_t<decltype(codec_traits<T>::fixed_size)>> : std::true_type {};
+
+    } // namespace detail
+
+    template <>
+    struct codec_traits<std::string> : detail::string_codec<std::string> {};
+
+    template <>
+    struct codec_traits<std::string_view> : detail::string_codec<std::string_view> {};
+
+    /*
+     * Vectors of trivially copyable values are copied in one block and decoded
+     * as packed_view, others element by element and decoded as vectors.
+     */
+    template <typename T, typename A>
+    struct codec_traits<std::vector<T, A>> {
+        using element = codec_traits<T>;
+        static constexpr bool packed = std::is_trivially_copyable_v<T>;
+        using view_type = std::conditional_t<packed, packed_view<T>, std::vector<T, A>>;
+
+        static std::size_t size(const std::vector<T, A>& v) noexcept {
+            if constexpr (packed) {
+                return sizeof(detail::codec_length) + v.size() * sizeof(T);
+            } else {
+                std::size_t n = sizeof(detail::codec_length);
+                for (auto& e : v) {
+                    n += element::size(e);
+                }
+                return n;
+            }
+        }
+
+        static unsigned char* encode(unsigned char *p, const std::vector<T, A>& v) noexcept {
+            p = detail::encode_length(p, v.size());
+            if constexpr (packed) {
+                if (!v.empty()) {
+                    std::memcpy(p, v.data(), v.size() * sizeof(T));
+                }
+                return p + v.size() * sizeof(T);
+            } else {
+                for (auto& e : v) {
+                    p = element::encode(p, e);
+                }
+                return p;
+            }
+        }
+
+        static bool decode(const unsigned char *&p, const unsigned char *end, view_type& v) {
+            std::size_t count;
+            if constexpr (packed) {
+                if (!detail::decode_length(p, end, sizeof(T), count)) {
+                    return false;
+                }
+                v = packed_view<T>(p, count);
+                p += count * sizeof(T);
+                return true;
+            } else {
+                // every element takes at least one byte, bounds the reservation
+                if (!detail::decode_length(p, end, 1, count)) {
+                    return false;
+                }
+                v.clear();
+                v.reserve(count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    typename element::view_type e{};
+                    if (!element::decode(p, end, e)) {
+                        return false;
+                    }
+                    v.push_back(element::load(e));
+                }
+                return true;
+            }
+        }
+
+        static std::vector<T, A> load(const view_type& v) {
+            if constexpr (packed) {
+                return v.template to_vector<A>();
+            } else {
+                return v;
+            }
+        }
+    };
+
+    /**
+     * codec encodes and decodes an argument pack, one codec_traits after the
+     * other with no padding between them.
+     *
+     * Encoding writes into a caller provided buffer and never allocates.
+     * Decoding hands views into the buffer where the traits allow it, such as
+     * std::string_view for std::string, so the buffer must outlive them.
+     *
+     * @tparam T... the argument types, as in signal<T...>
+     */
+    template <typename... T>
+    struct codec {
+        /**
+         * true when every argument encodes on a known number of bytes
+         */
+        static constexpr bool is_fixed_size = (detail::has_fixed_size<std::decay_t<T>>::value && ...);
+
+        /**
+         * Number of bytes of an encoded pack, for fixed size packs
+         */
+        static constexpr std::size_t fixed_size() noexcept {
+            if constexpr (is_fixed_size) {
+                return (std::size_t{0} + ... + codec_traits<std::decay_t<T>>::fixed_size);
+            } else {
+                return 0;
+            }
+        }
+
+        /**
+         * Rough identity of the encoding, used to detect peers built with other
+         * argument types
+         */
+        static constexpr std::uint64_t signature() noexcept {
+            std::uint64_t h = 1469598103934665603ULL;
+            ((h = (h ^ type_code<std::decay_t<T>>()) * 1099511628211ULL), ...);
+            return h;
+        }
+
+        /**
+         * Number of bytes needed to encode the arguments
+         */
+        static std::size_t size(const std::decay_t<T>& ...a) noexcept {
+            return (std::size_t{0} + ... + codec_traits<std::decay_t<T>>::size(a));
+        }
+
+        /**
+         * Encode the arguments at p, which must hold size(a...) bytes
+         *
+         * @return the end of the encoded bytes
+         */
+        static unsigned char* encode(unsigned char *p, const std::decay_t<T>& ...a) noexcept {
+            ((p = codec_traits<std::decay_t<T>>::encode(p, a)), ...);
+            return p;
+        }
+
+        /**
+         * Encode the arguments in buffer if they fit in capacity bytes
+         *
+         * @return the number of bytes written, 0 if the buffer is too small
+         */
+        static std::size_t encode(unsigned char *buffer, std::size_t capacity, const std::decay_t<T>& ...a) noexcept {
+            const std::size_t n = size(a...);
+            if (n > capacity) {
+                return 0;
+            }
+            encode(buffer, a...);
+            return n;
+        }
+
+        /**
+         * Decode size bytes at p and call f with the views of the arguments
+         *
+         * @return false if the bytes are not a well formed pack
+         */
+        template <typename F>
+        static bool decode_views(const unsigned char *p, std::size_t size, F&& f) {
+            std::tuple<typename codec_traits<std::decay_t<T>>::view_type...> views;
+            if (!decode_all(p, p + size, views, std::index_sequence_for<T...>{})) {
+                return false;
+            }
+            std::apply(std::forward<F>(f), views);
+            return true;
+        }
+
+        /**
+         * Decode size bytes at p and call f with the arguments, as the slots of
+         * a signal<T...> would receive them
+         *
+         * @return false if the bytes are not a well formed pack
+         */
+        template <typename F>
+        static bool decode(const unsigned char *p, std::size_t size, F&& f) {
+            return decode_views(p, size, [&f](const auto& ...v) {
+                f(codec_traits<std::decay_t<T>>::load(v)...);
+            });
+        }
+
+    private:
+        template <typename U>
+        static constexpr std::uint64_t type_code() noexcept {
+            if constexpr (detail::has_fixed_size<U>::value) {
+                return (static_cast<std::uint64_t>(codec_traits<U>::fixed_size) << 8) | alignof(U);
+            } else {
+                return ~static_cast<std::uint64_t>(alignof(U));
+            }
+        }
+
+        template <typename Views, std::size_t... I>
+        static bool decode_all(const unsigned char *p, const unsigned char *end, Views& views, std::index_sequence<I...>) {
+            return (codec_traits<std::decay_t<T>>::decode(p, end, std::get<I>(views)) && ...) && p == end;
+        }
+    };
+
+} // namespace sigslot
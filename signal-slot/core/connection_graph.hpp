@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "signal.hpp"
+
+namespace sigslot {
+
+    /**
+     * connection_graph reports the signal topology of the process: every signal
+     * created once it is enabled, its slots, their connection type, target
+     * queues and delivery counts, exported as Graphviz DOT or JSON to find hot
+     * fan-outs, blocking connections and unnecessary thread hops.
+     *      * Tracking is opt-in and process wide. Signals created before enable() are
+     * not tracked, enable it at startup. Tracked slots count their deliveries
+     * with a relaxed atomic increment, untracked ones pay a single branch.
+     */
+    class connection_graph {
+    public:
+        /**
+         * Track the signals created from now on
+         */
+        static void enable() noexcept {
+            detail::graph_registry::instance().enable();
+        }
+
+        /**
+         * Stop tracking the signals created from now on, the tracked ones stay
+         * in the graph until destroyed
+         */
+        static void disable() noexcept {
+            detail::graph_registry::instance().disable();
+        }
+
+        static bool enabled() noexcept {
+            return detail::graph_registry::instance().enabled();
+        }
+
+        /**
+         * Name a tracked signal in the exports
+         *          * @return false if the signal is not tracked
+         */
+        template <typename Lockable, typename... T>
+        static bool set_name(const signal_base<Lockable, T...>& sig, std::string_view name) {
+            return detail::graph_registry::instance().set_name(&sig, name);
+        }
+
+        /**
+         * The tracked signals and their connections, in creation order
+         */
+        static std::vector<graph_node> snapshot() {
+            return detail::graph_registry::instance().snapshot();
+        }
+
+        /**
+         * Graphviz DOT rendering: signals are boxes, queues ellipses, and direct
+         * connections point to the emitting thread. Edges are labelled with the
+         * connection type and delivery count, thicker for busier connections;
+         * blocking connections are red, auto connections dashed.
+         */
+        static std::string to_dot(const std::vector<graph_node>& nodes) {
+            std::string out = "digraph sigslot {\n    rankdir=LR;\n";
+            std::set<const void*> known;
+            for (auto& n : nodes) {
+                known.insert(n.signal);
+                out += "    " + quote(signal_id(n.signal)) + " [shape=box,label=" +
+                       quote(label(n), std::to_string(n.edges.size()) + " slots") + "];\n";
+            }
+
+            std::set<std::string> queues;
+            std::set<const void*> chained;
+            bool caller = false;
+            for (auto& n : nodes) {
+                for (auto& e : n.edges) {
+                    if (e.target) {
+                        if (!known.count(e.target)) {
+                            chained.insert(e.target);
+                        }
+                    } else if (e.queues.empty()) {
+                        caller = true;
+                    }
+                    queues.insert(e.queues.begin(), e.queues.end());
+                }
+            }
+            for (auto& q : queues) {
+                out += "    " + quote("queue:" + q) + " [shape=ellipse,label=" + quote(q) + "];\n";
+            }
+            for (auto *c : chained) {
+                out += "    " + quote(signal_id(c)) + " [shape=box,style=dotted,label=" + quote(pointer(c)) + "];\n";
+            }
+            if (caller) {
+                out += "    \"caller\" [shape=plaintext,label=\"emitting thread\"];\n";
+            }
+
+            for (auto& n : nodes) {
+                for (auto& e : n.edges) {
+                    std::string attributes = "label=" + quote(type_name(e.type), std::to_string(e.deliveries));
+                    char width[32];
+                    std::snprintf(width, sizeof(width), ",penwidth=%.1f", 1.0 + std::log10(1.0 + static_cast<double>(e.deliveries)));
+                    attributes += width;
+                    if (e.type == connection_type::blocking_queued_connection) {
+                        attributes += ",color=red";
+                    } else if (e.type == connection_type::auto_connection) {
+                        attributes += ",style=dashed";
+                    }
+                    if (e.blocked) {
+                        attributes += ",color=gray";
+                    }
+
+                    const std::string from = "    " + quote(signal_id(n.signal)) + " -> ";
+                    if (e.target) {
+                        out += from + quote(signal_id(e.target)) + " [" + attributes + "];\n";
+                    } else if (e.queues.empty()) {
+                        out += from + "\"caller\" [" + attributes + "];\n";
+                    } else {
+                        for (auto& q : e.queues) {
+                            out += from + quote("queue:" + q) + " [" + attributes + "];\n";
+                        }
+                    }
+                }
+            }
+            out += "}\n";
+            return out;
+        }
+
+        static std::string to_dot() {
+            return to_dot(snapshot());
+        }
+
+        /**
+         * JSON rendering, an object holding the array of signals, each with the
+         * array of its slots. Pointers are hexadecimal strings, null if absent.
+         */
+        static std::string to_json(const std::vector<graph_node>& nodes) {
+            std::string out = "{\"signals\":[";
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                auto& n = nodes[i];
+                out += i ? ",{" : "{";
+                out += "\"id\":" + quote(pointer(n.signal)) + ",\"name\":" + quote(n.name) + ",\"slots\":[";
+                for (std::size_t j = 0; j < n.edges.size(); ++j) {
+                    auto& e = n.edges[j];
+                    out += j ? ",{" : "{";
+                    out += "\"type\":" + quote(type_name(e.type));
+                    out += ",\"group\":" + std::to_string(e.group);
+                    out += ",\"queues\":[";
+                    for (std::size_t k = 0; k < e.queues.size(); ++k) {
+                        out += (k ? "," : "") + quote(e.queues[k]);
+                    }
+                    out += "],\"object\":" + (e.object ? quote(pointer(e.object)) : std::string("null"));
+                    out += ",\"target\":" + (e.target ? quote(pointer(e.target)) : std::string("null"));
+                    out += ",\"deliveries\":" + std::to_string(e.deliveries);
+                    out += std::string(",\"blocked\":") + (e.blocked ? "true" : "false") + "}";
+                }
+                out += "]}";
+            }
+            out += "]}\n";
+            return out;
+        }
+
+        static std::string to_json() {
+            return to_json(snapshot());
+        }
+
+    private:
+        static const char* type_name(std::uint32_t type) noexcept {
+            switch (type) {
+            case connection_type::auto_connection: return "auto";
+            case connection_type::direct_connection: return "direct";
+            case connection_type::queued_connection: return "queued";
+            case connection_type::blocking_queued_connection: return "blocking_queued";
+            default: return "unknown";
+            }
+        }
+
+        static std::string pointer(const void *p) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%p", p);
+            return buffer;
+        }
+
+        static std::string signal_id(const void *p) {
+            return "signal:" + pointer(p);
+        }
+
+        static std::string label(const graph_node& n) {
+            return n.name.empty() ? pointer(n.signal) : n.name;
+        }
+
+        // escaped for a double quoted string, valid both in DOT and in JSON
+        static std::string escape(std::string_view s) {
+            std::string out;
+            for (const char c : s) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+            }
+            return out;
+        }
+
+        static std::string quote(std::string_view s) {
+            return "\"" + escape(s) + "\"";
+        }
+
+        // a two lines DOT label
+        static std::string quote(std::string_view first, std::string_view second) {
+            return "\"" + escape(first) + "\\n" + escape(second) + "\"";
+        }
+    };
+
+} // namespace sigslot
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace sigslot {
+
+    /**
+     * Live allocations and bytes of a memory category, see memory_stats()
+     */
+    struct memory_usage {
+        std::uint64_t objects = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    namespace detail {
+
+        /*
+         * Counters of a memory category. Allocations and releases may happen on
+         * different threads, counters are relaxed atomics: each one is exact on
+         * its own, both together may be off by the allocations in flight.
+         */
+        class memory_counter {
+        public:
+            void add(std::size_t bytes) noexcept {
+                m_objects.fetch_add(1, std::memory_order_relaxed);
+                m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+
+            void sub(std::size_t bytes) noexcept {
+                m_objects.fetch_sub(1, std::memory_order_relaxed);
+                m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            }
+
+            memory_usage usage() const noexcept {
+                return {m_objects.load(std::memory_order_relaxed), m_bytes.load(std::memory_order_relaxed)};
+            }
+
+        private:
+            std::atomic<std::uint64_t> m_objects{0};
+            std::atomic<std::uint64_t> m_bytes{0};
+        };
+
+        /*
+         * The counters of the library allocations. Accounting is always on, it
+         * costs two relaxed atomic additions per allocation, and allocations only
+         * happen on connection, disconnection and delayed posts, never on direct
+         * emission. The registry is never destroyed: slots of static signals may
+         * be released after the exit handlers ran.
+         */
+        class memory_registry {
+        public:
+            static memory_registry& instance() {
+                static auto *registry = new memory_registry;
+                return *registry;
+            }
+
+            // counter of the slots of a type, created on first use
+            memory_counter& slot_counter(const char *type) {
+                std::lock_guard<std::mutex> _{m_mutex};
+                return m_slots.emplace_back(std::piecewise_construct, std::forward_as_tuple(type), std::forward_as_tuple()).second;
+            }
+
+            std::vector<std::pair<const char*, memory_usage>> slot_usage() const {
+                std::lock_guard<std::mutex> _{m_mutex};
+                std::vector<std::pair<const char*, memory_usage>> usage;
+                usage.reserve(m_slots.size());
+                for (auto& s : m_slots) {
+                    usage.emplace_back(s.first, s.second.usage());
+                }
+                return usage;
+            }
+
+            memory_counter slot_lists;      // slot vectors of the signals
+            memory_counter cow_payloads;    // copy on write payloads of the slot lists
+            memory_counter observers;       // connection lists of the observers
+            memory_counter delayed_nodes;   // delayed task map nodes of the task queues
+            std::atomic<std::uint64_t> cow_copies{0};
+
+        private:
+            memory_registry() = default;
+
+            mutable std::mutex m_mutex;
+            std::deque<std::pair<const char*, memory_counter>> m_slots;    // stable addresses
+        };
+
+        // categories of counting_allocator
+        struct slot_list_memory {
+            static memory_counter& counter() { return memory_registry::instance().slot_lists; }
+        };
+
+        struct observer_memory {
+            static memory_counter& counter() { return memory_registry::instance().observers; }
+        };
+
+        struct delayed_node_memory {
+            static memory_counter& counter() { return memory_registry::instance().delayed_nodes; }
+        };
+
+        template <typename Slot>
+        struct slot_memory {
+            static memory_counter& counter() {
+#if defined(__GXX_RTTI) || defined(__cpp_rtti) || defined(_CPPRTTI)
+                static memory_counter& c = memory_registry::instance().slot_counter(typeid(Slot).name());
+#else
+                static memory_counter& c = memory_registry::instance().slot_counter("slot");
+#endif
+                return c;
+            }
+        };
+
+    } // namespace detail
+
+    /**
+     * counting_allocator is a stateless std::allocator accounting each allocation
+     * to the counter of its Category, a type with a static counter() function
+     * returning a detail::memory_counter. It adds no storage to the containers
+     * and shared pointers using it, rebinding keeps the category, so the control
+     * block of std::allocate_shared and the nodes of a std::map are accounted
+     * with their full size.
+     */
+    template <typename T, typename Category>
+    class counting_allocator {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = counting_allocator<U, Category>;
+        };
+
+        counting_allocator() noexcept = default;
+
+        template <typename U>
+        counting_allocator(const counting_allocator<U, Category>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            T *p = std::allocator<T>{}.allocate(n);
+            Category::counter().add(n * sizeof(T));
+            return p;
+        }
+
+        void deallocate(T *p, std::size_t n) noexcept {
+            Category::counter().sub(n * sizeof(T));
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template <typename U>
+        bool operator==(const counting_allocator<U, Category>&) const noexcept {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const counting_allocator<U, Category>&) const noexcept {
+            return false;
+        }
+    };
+
+} // namespace sigslot
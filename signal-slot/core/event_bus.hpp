@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "signal.hpp"
+
+namespace sigslot {
+
+    namespace detail {
+
+        inline std::size_t next_event_type_id() noexcept {
+            static std::atomic<std::size_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /*
+         * Identifies an event type without RTTI. Ids are small sequential integers
+         * assigned on first use, suitable to index a dense table.
+         */
+        template <typename E>
+        std::size_t event_type_id() noexcept {
+            static const std::size_t id = next_event_type_id();
+            return id;
+        }
+
+    } // namespace detail
+
+    /**
+     * event_bus_base is a publish/subscribe hub whose channels are event types.
+     *      * Every event type E owns a signal_base<Lockable, const E&>, created on the
+     * first subscription and stored in a dense table indexed by a compile-time
+     * assigned type id, so publishing only costs an index lookup before the
+     * emission. All the connection types and connect overloads of signal_base
+     * are available through subscribe().
+     *      * @tparam Lockable a lock type to decide the lock policy
+     */
+    template <typename Lockable>
+    class event_bus_base {
+        using lock_type = std::unique_lock<Lockable>;
+
+        struct channel_base {
+            virtual ~channel_base() = default;
+        };
+
+        template <typename E>
+        struct channel final : channel_base {
+            signal_base<Lockable, const E&> sig;
+        };
+
+    public:
+        template <typename E>
+        using signal_type = signal_base<Lockable, const E&>;
+
+        event_bus_base() = default;
+        ~event_bus_base() = default;
+
+        event_bus_base(const event_bus_base&) = delete;
+        event_bus_base& operator=(const event_bus_base&) = delete;
+
+        /**
+         * Publish an event
+         *          * Effect: The slots subscribed to type E are called with the event, according
+         *         to their connection type.
+         * Safety: Same guarantees as signal_base emission.
+         *          * @param event the event to publish
+         */
+        template <typename E>
+        void publish(const E& event) const {
+            if (auto *c = find<E>()) {
+                c->sig(event);
+            }
+        }
+
+        /**
+         * Subscribe to events of type E
+         * Use the same semantics as signal_base::connect, the slot is called with
+         * a const E& argument.
+         *          * @return a connection object that can be used to interact with the slot
+         */
+        template <typename E, typename... CallArgs>
+        connection subscribe(CallArgs&& ...args) {
+            return signal<E>().connect(std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Creates a subscription whose duration is tied to the return object
+         * Use the same semantics as subscribe
+         */
+        template <typename E, typename... CallArgs>
+        scoped_connection subscribe_scoped(CallArgs&& ...args) {
+            return subscribe<E>(std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Access the signal of events of type E, created if necessary
+         */
+        template <typename E>
+        signal_type<E>& signal() {
+            const auto id = detail::event_type_id<E>();
+            lock_type lock(m_mutex);
+            if (id >= m_channels.size()) {
+                m_channels.resize(id + 1);
+            }
+            auto& c = m_channels[id];
+            if (!c) {
+                c = std::make_unique<channel<E>>();
+            }
+            return static_cast<channel<E>*>(c.get())->sig;
+        }
+
+        /**
+         * Get number of slots subscribed to events of type E
+         * Safety: thread safe
+         */
+        template <typename E>
+        size_t subscriber_count() const {
+            auto *c = find<E>();
+            return c ? c->sig.slot_count() : 0;
+        }
+
+    private:
+        // channels are never destroyed before the bus, the pointer remains valid
+        template <typename E>
+        channel<E>* find() const {
+            const auto id = detail::event_type_id<E>();
+            lock_type lock(m_mutex);
+            return id < m_channels.size() ? static_cast<channel<E>*>(m_channels[id].get()) : nullptr;
+        }
+
+    private:
+        mutable Lockable m_mutex;
+        std::vector<std::unique_ptr<channel_base>> m_channels;
+    };
+
+    /**
+     * Specialization of event_bus_base to be used in single threaded contexts.
+     */
+    using event_bus_st = event_bus_base<detail::null_mutex>;
+
+    /**
+     * Specialization of event_bus_base to be used in multi-threaded contexts.
+     */
+    using event_bus = event_bus_base<std::mutex>;
+
+} // namespace sigslot
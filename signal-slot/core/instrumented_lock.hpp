@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace sigslot {
+
+    /**
+     * A copy of a lock_histogram: bucket i counts the durations shorter than
+     * 2^i nanoseconds and not counted by the previous buckets, the last one
+     * the longer ones.
+     */
+    struct lock_histogram_snapshot {
+        static constexpr std::size_t bucket_count = 40;
+
+        std::array<std::uint64_t, bucket_count> buckets{};
+        std::uint64_t count = 0;
+        std::uint64_t total_ns = 0;
+
+        /**
+         * Upper bound of the bucket holding the p quantile, 0 < p <= 1
+         */
+        std::chrono::nanoseconds percentile(double p) const noexcept {
+            if (count == 0) {
+                return std::chrono::nanoseconds(0);
+            }
+            const double target = p * static_cast<double>(count);
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                cumulative += buckets[i];
+                if (cumulative > 0 && static_cast<double>(cumulative) >= target) {
+                    return std::chrono::nanoseconds(std::int64_t{1} << i);
+                }
+            }
+            return std::chrono::nanoseconds(std::int64_t{1} << (bucket_count - 1));
+        }
+
+        std::chrono::nanoseconds mean() const noexcept {
+            return std::chrono::nanoseconds(count ? total_ns / count : 0);
+        }
+    };
+
+    /**
+     * Counters of an instrumented_lock
+     */
+    struct lock_stats {
+        std::uint64_t acquisitions = 0;
+        std::uint64_t contended = 0;        // acquisitions that had to wait
+        lock_histogram_snapshot wait;       // time to acquire, zero when uncontended
+        lock_histogram_snapshot hold;       // time between acquisition and release
+    };
+
+    namespace detail {
+
+        /*
+         * Power of two histogram of durations. It is only written by the holder
+         * of the lock it measures, so updates are plain relaxed stores; readers
+         * get each counter consistent on its own.
+         */
+        class lock_histogram {
+        public:
+            void record(std::chrono::nanoseconds d) noexcept {
+                const auto ns = static_cast<std::uint64_t>(d.count() > 0 ? d.count() : 0);
+                std::size_t bucket = 0;
+                for (std::uint64_t v = ns; v != 0 && bucket + 1 < lock_histogram_snapshot::bucket_count; v >>= 1) {
+                    ++bucket;
+                }
+                bump(m_buckets[bucket], 1);
+                bump(m_count, 1);
+                bump(m_total_ns, ns);
+            }
+
+            lock_histogram_snapshot snapshot() const noexcept {
+                lock_histogram_snapshot s;
+                for (std::size_t i = 0; i < s.buckets.size(); ++i) {
+                    s.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+                }
+                s.count = m_count.load(std::memory_order_relaxed);
+                s.total_ns = m_total_ns.load(std::memory_order_relaxed);
+                return s;
+            }
+
+            void reset() noexcept {
+                for (auto& b : m_buckets) {
+                    b.store(0, std::memory_order_relaxed);
+                }
+                m_count.store(0, std::memory_order_relaxed);
+                m_total_ns.store(0, std::memory_order_relaxed);
+            }
+
+        private:
+            static void bump(std::atomic<std::uint64_t>& v, std::uint64_t n) noexcept {
+                v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+
+            std::atomic<std::uint64_t> m_buckets[lock_histogram_snapshot::bucket_count] = {};
+            std::atomic<std::uint64_t> m_count{0};
+            std::atomic<std::uint64_t> m_total_ns{0};
+        };
+
+    } // namespace detail
+
+    /**
+     * instrumented_lock wraps a Lockable to profile its contention: the number
+     * of acquisitions, how many had to wait, and histograms of the wait and hold
+     * times. It is itself a Lockable, so it can be the lock policy of signal_base
+     * or observer_base to find out which signal is hot:
+     *
+     *   sigslot::signal_base<sigslot::instrumented_lock<std::mutex>, int> sig;
+     *   ...
+     *   auto stats = sig.lockable().stats();
+     *
+     * An acquisition first tries the lock, the clock is only read twice for an
+     * uncontended one. Counters are updated while the lock is held, so they
+     * need no atomic read-modify-write. A disabled lock forwards to the wrapped
+     * one and records nothing.
+     *
+     * @tparam Lockable a lock type with lock(), unlock() and try_lock()
+     */
+    template <typename Lockable>
+    class instrumented_lock {
+        using clock_type = std::chrono::steady_clock;
+
+    public:
+        instrumented_lock() = default;
+        explicit instrumented_lock(bool enabled) noexcept : m_enabled(enabled) {}
+
+        instrumented_lock(const instrumented_lock&) = delete;
+        instrumented_lock& operator=(const instrumented_lock&) = delete;
+
+        void lock() {
+            if (!m_enabled) {
+                m_lock.lock();
+                return;
+            }
+            if (m_lock.try_lock()) {
+                acquired(clock_type::now(), false, std::chrono::nanoseconds(0));
+                return;
+            }
+            const auto start = clock_type::now();
+            m_lock.lock();
+            const auto now = clock_type::now();
+            acquired(now, true, now - start);
+        }
+
+        bool try_lock() {
+            if (!m_lock.try_lock()) {
+                return false;
+            }
+            if (m_enabled) {
+                acquired(clock_type::now(), false, std::chrono::nanoseconds(0));
+            }
+            return true;
+        }
+
+        void unlock() {
+            if (m_enabled) {
+                m_hold.record(clock_type::now() - m_acquired);
+            }
+            m_lock.unlock();
+        }
+
+        bool enabled() const noexcept {
+            return m_enabled;
+        }
+
+        /**
+         * The counters so far, readable from any thread
+         */
+        lock_stats stats() const noexcept {
+            lock_stats s;
+            s.acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+            s.contended = m_contended.load(std::memory_order_relaxed);
+            s.wait = m_wait.snapshot();
+            s.hold = m_hold.snapshot();
+            return s;
+        }
+
+        /**
+         * Clear the counters, with the lock held to not race with a holder
+         */
+        void reset() {
+            m_lock.lock();
+            m_acquisitions.store(0, std::memory_order_relaxed);
+            m_contended.store(0, std::memory_order_relaxed);
+            m_wait.reset();
+            m_hold.reset();
+            m_lock.unlock();
+        }
+
+        Lockable& native() noexcept {
+            return m_lock;
+        }
+
+    private:
+        void acquired(clock_type::time_point now, bool contended, std::chrono::nanoseconds wait) noexcept {
+            m_acquired = now;
+            m_acquisitions.store(m_acquisitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (contended) {
+                m_contended.store(m_contended.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            m_wait.record(wait);
+        }
+
+    private:
+        Lockable m_lock;
+        const bool m_enabled = true;
+        clock_type::time_point m_acquired{};    // only used by the holder
+        std::atomic<std::uint64_t> m_acquisitions{0};
+        std::atomic<std::uint64_t> m_contended{0};
+        detail::lock_histogram m_wait;
+        detail::lock_histogram m_hold;
+    };
+
+} // namespace sigslot
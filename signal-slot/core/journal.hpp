@@ -0,0 +1,370 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "signal.hpp"
+#include "codec.hpp"
+#include "mapped_file.hpp"
+
+namespace sigslot {
+
+    namespace detail {
+
+        /*
+         * A journal is a set of memory mapped segment files named path.0,
+         * path.1, ... Each segment is written by a single thread and holds
+         * records, each made of a journal_record header followed by the encoded
+         * arguments, padded to 8 bytes. used is published after each record, so
+         * a reader never sees a partially written one.
+         */
+        struct journal_segment_header {
+            static constexpr std::uint64_t magic_value = 0x53494a524e4c3031ULL;  // "SIGJRNL1"
+
+            std::uint64_t magic;
+            std::uint64_t signature;
+            std::uint64_t capacity;         // bytes available for records
+            std::atomic<std::uint64_t> used;
+        };
+
+        struct journal_record {
+            std::uint32_t size;
+            std::uint32_t reserved;
+            std::uint64_t time;             // nanoseconds since the recorder started
+            std::uint64_t sequence;         // emission order across threads
+        };
+
+        constexpr std::size_t journal_align(std::size_t n) noexcept {
+            return (n + 7) & ~std::size_t{7};
+        }
+
+        constexpr std::size_t journal_header_size = journal_align(sizeof(journal_segment_header));
+
+        inline std::string journal_segment_path(const std::string& path, std::size_t index) {
+            return path + "." + std::to_string(index);
+        }
+
+        /*
+         * Shared state of a journal_recorder, kept alive by the attached slots.
+         * Every emitting thread gets its own segment, found through a thread
+         * local cache, so recording only takes the mutex to open a segment.
+         */
+        class journal_state {
+            struct writer {
+                std::unique_ptr<core::MappedFile> file;
+                journal_segment_header *header = nullptr;
+                std::size_t used = 0;
+                std::atomic<std::uint64_t> records{0};
+            };
+
+        public:
+            journal_state(std::string path, std::uint64_t signature, std::size_t segment_size)
+            : m_id(next_id())
+            , m_path(std::move(path))
+            , m_signature(signature)
+            , m_segment_size(std::max(segment_size, journal_header_size + 4096))
+            , m_origin(std::chrono::steady_clock::now())
+            {
+                // drop the segments of a previous journal at the same path
+                for (std::size_t i = 0; core::MappedFile::Remove(journal_segment_path(m_path, i)); ++i) {}
+            }
+
+            // append a record of size bytes, filled by encode
+            template <typename Encode>
+            bool append(std::size_t size, Encode&& encode) {
+                const std::size_t need = journal_align(sizeof(journal_record) + size);
+                auto& w = current_writer();
+                if (!w.header || w.used + need > w.header->capacity) {
+                    if (need > m_segment_size - journal_header_size || !open_segment(w)) {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                }
+
+                auto *p = static_cast<unsigned char*>(w.file->Data()) + journal_header_size + w.used;
+                journal_record record{};
+                record.size = static_cast<std::uint32_t>(size);
+                record.time = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - m_origin).count());
+                record.sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+                std::memcpy(p, &record, sizeof(record));
+                encode(p + sizeof(record));
+
+                w.used += need;
+                w.header->used.store(w.used, std::memory_order_release);
+                w.records.store(w.records.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            std::uint64_t records() const {
+                std::lock_guard<std::mutex> _{m_mutex};
+                std::uint64_t n = 0;
+                for (auto& w : m_writers) {
+                    n += w->records.load(std::memory_order_relaxed);
+                }
+                return n;
+            }
+
+            std::uint64_t dropped() const noexcept {
+                return m_dropped.load(std::memory_order_relaxed);
+            }
+
+        private:
+            static std::uint64_t next_id() noexcept {
+                static std::atomic<std::uint64_t> id{0};
+                return ++id;
+            }
+
+            struct cache_entry {
+                std::uint64_t id;
+                writer *w;
+                std::weak_ptr<const writer> alive;
+            };
+
+            // states are told apart by an id never reused, so that stale cache
+            // entries of destroyed recorders never match, and are dropped on a miss
+            writer& current_writer() {
+                thread_local std::vector<cache_entry> cache;
+                for (auto& e : cache) {
+                    if (e.id == m_id) {
+                        return *e.w;
+                    }
+                }
+                cache.erase(std::remove_if(cache.begin(), cache.end(), [](const cache_entry& e) {
+                    return e.alive.expired();
+                }), cache.end());
+                std::lock_guard<std::mutex> _{m_mutex};
+                m_writers.push_back(std::make_shared<writer>());
+                cache.push_back({m_id, m_writers.back().get(), m_writers.back()});
+                return *m_writers.back();
+            }
+
+            // replace the segment of a writer, the previous one is complete. The
+            // file is created under the mutex and only takes an index once
+            // created, so that the segments of a journal have no gap.
+            bool open_segment(writer& w) {
+                std::unique_ptr<core::MappedFile> file;
+                {
+                    std::lock_guard<std::mutex> _{m_mutex};
+                    file = core::MappedFile::Create(journal_segment_path(m_path, m_segments), m_segment_size);
+                    if (!file) {
+                        return false;
+                    }
+                    ++m_segments;
+                }
+                auto *header = new (file->Data()) journal_segment_header;
+                header->signature = m_signature;
+                header->capacity = m_segment_size - journal_header_size;
+                header->used.store(0, std::memory_order_relaxed);
+                header->magic = journal_segment_header::magic_value;
+
+                // the previous segment is unmapped, only its thread wrote to it
+                w.file = std::move(file);
+                w.header = header;
+                w.used = 0;
+                return true;
+            }
+
+        private:
+            const std::uint64_t m_id;
+            const std::string m_path;
+            const std::uint64_t m_signature;
+            const std::size_t m_segment_size;
+            const std::chrono::steady_clock::time_point m_origin;
+
+            mutable std::mutex m_mutex;
+            std::vector<std::shared_ptr<writer>> m_writers;      // shared with the thread caches as weak_ptr
+            std::size_t m_segments = 0;
+
+            std::atomic<std::uint64_t> m_sequence{0};
+            std::atomic<std::uint64_t> m_dropped{0};
+        };
+
+    } // namespace detail
+
+    /**
+     * journal_recorder appends timestamped emissions to an append-only binary
+     * journal made of memory mapped segment files, to be replayed later with a
+     * journal_replayer, for instance to reproduce production traffic in a test
+     * or a benchmark.
+     *      * Each emitting thread writes its own segments, so recording takes no lock
+     * and makes no system call but when a segment is full. Arguments are encoded
+     * with codec<T...>. A journal is named by a path, its segments being
+     * path.0, path.1, ...; creating a recorder removes the journal found there.
+     *      * @tparam T... the argument types of the emitting and slots functions.
+     */
+    template <typename... T>
+    class journal_recorder {
+        using codec_type = codec<T...>;
+
+    public:
+        /**
+         * @param path the path of the journal, segments are created next to it
+         * @param segment_size the size of each segment file
+         */
+        explicit journal_recorder(std::string path, std::size_t segment_size = 4 * 1024 * 1024)
+        : m_state(std::make_shared<detail::journal_state>(std::move(path), codec_type::signature(), segment_size))
+        {}
+
+        journal_recorder(const journal_recorder&) = delete;
+        journal_recorder& operator=(const journal_recorder&) = delete;
+
+        /**
+         * Record an emission, returns false if it could not be written
+         */
+        bool record(const std::decay_t<T>& ...a) {
+            return m_state->append(codec_type::size(a...), [&](unsigned char *p) {
+                codec_type::encode(p, a...);
+            });
+        }
+
+        bool operator()(const std::decay_t<T>& ...a) {
+            return record(a...);
+        }
+
+        /**
+         * Record the emissions of a signal, from the emitting thread
+         */
+        template <typename Lockable>
+        connection attach(signal_base<Lockable, T...>& sig) {
+            return sig.connect([state = m_state](const std::decay_t<T>& ...a) {
+                state->append(codec_type::size(a...), [&](unsigned char *p) {
+                    codec_type::encode(p, a...);
+                });
+            });
+        }
+
+        // number of emissions recorded, and of emissions lost because a segment
+        // could not be created or they were larger than a segment
+        std::uint64_t records() const { return m_state->records(); }
+        std::uint64_t dropped() const noexcept { return m_state->dropped(); }
+
+    private:
+        std::shared_ptr<detail::journal_state> m_state;
+    };
+
+    /**
+     * journal_replayer reads a journal written by a journal_recorder<T...> and
+     * re-emits its records in their original order, at the original pace or
+     * faster.
+     *      * @tparam T... the argument types of the recorder
+     */
+    template <typename... T>
+    class journal_replayer {
+        using codec_type = codec<T...>;
+
+        struct entry {
+            std::uint64_t sequence;
+            std::uint64_t time;
+            const unsigned char *payload;
+            std::uint32_t size;
+        };
+
+    public:
+        /**
+         * Map the segments of the journal at path. Segments created for other
+         * argument types, or corrupted, are skipped.
+         */
+        explicit journal_replayer(const std::string& path) {
+            for (std::size_t i = 0;; ++i) {
+                auto file = core::MappedFile::Open(detail::journal_segment_path(path, i));
+                if (!file) {
+                    break;
+                }
+                if (load(*file)) {
+                    m_files.push_back(std::move(file));
+                }
+            }
+            std::sort(m_entries.begin(), m_entries.end(), [](const entry& a, const entry& b) {
+                return a.sequence < b.sequence;
+            });
+        }
+
+        journal_replayer(const journal_replayer&) = delete;
+        journal_replayer& operator=(const journal_replayer&) = delete;
+
+        /**
+         * Number of records in the journal
+         */
+        std::size_t size() const noexcept {
+            return m_entries.size();
+        }
+
+        bool empty() const noexcept {
+            return m_entries.empty();
+        }
+
+        /**
+         * Time between the start of the recorder and the last record
+         */
+        std::chrono::nanoseconds span() const noexcept {
+            return std::chrono::nanoseconds(m_entries.empty() ? 0 : m_entries.back().time);
+        }
+
+        /**
+         * Call f, typically a signal, with the arguments of each record, from
+         * the calling thread.
+         *          * @param speed 1 replays at the original pace, 2 twice as fast, and 0 as
+         *              fast as possible
+         * @return the number of records replayed
+         */
+        template <typename F>
+        std::size_t replay(F&& f, double speed = 1.0) {
+            const auto start = std::chrono::steady_clock::now();
+            std::size_t n = 0;
+            for (auto& e : m_entries) {
+                if (speed > 0) {
+                    std::this_thread::sleep_until(start + std::chrono::nanoseconds(
+                        static_cast<std::int64_t>(static_cast<double>(e.time) / speed)));
+                }
+                if (codec_type::decode(e.payload, e.size, f)) {
+                    ++n;
+                }
+            }
+            return n;
+        }
+
+    private:
+        bool load(const core::MappedFile& file) {
+            if (file.Size() < detail::journal_header_size) {
+                return false;
+            }
+            auto *base = static_cast<const unsigned char*>(file.Data());
+            auto *header = reinterpret_cast<const detail::journal_segment_header*>(base);
+            const auto used = header->used.load(std::memory_order_acquire);
+            if (header->magic != detail::journal_segment_header::magic_value ||
+                header->signature != codec_type::signature() ||
+                used > file.Size() - detail::journal_header_size) {
+                return false;
+            }
+
+            const unsigned char *p = base + detail::journal_header_size;
+            const unsigned char *end = p + used;
+            while (static_cast<std::size_t>(end - p) >= sizeof(detail::journal_record)) {
+                detail::journal_record record;
+                std::memcpy(&record, p, sizeof(record));
+                const std::size_t length = detail::journal_align(sizeof(record) + record.size);
+                if (length > static_cast<std::size_t>(end - p)) {
+                    break;
+                }
+                m_entries.push_back({record.sequence, record.time, p + sizeof(record), record.size});
+                p += length;
+            }
+            return true;
+        }
+
+    private:
+        std::vector<std::unique_ptr<core::MappedFile>> m_files;
+        std::vector<entry> m_entries;
+    };
+
+} // namespace sigslot
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include "signal.hpp"
+
+namespace sigslot {
+
+    /**
+     * keyed_signal_base is a signal whose slots are connected for a given key, and
+     * whose emissions are only delivered to the slots of the emitted key.
+     *      * Each key owns a regular signal_base, looked up through a hash index upon
+     * emission, so the cost of an emission is proportional to the number of slots
+     * connected for that key instead of the total number of slots. All the
+     * connection types and connect overloads of signal_base are available.
+     *      * The index is copy on write like the slot lists of signal_base: emissions
+     * only take the lock to share it, and look the key up outside of it. The
+     * signals of keys left without slots are pruned as new keys are connected.
+     *      * @tparam Lockable a lock type to decide the lock policy
+     * @tparam Key the key type, must be hashable with std::hash
+     * @tparam T... the argument types of the emitting and slots functions.
+     */
+    template <typename Lockable, typename Key, typename... T>
+    class keyed_signal_base {
+        using signal_type = signal_base<Lockable, T...>;
+        using signal_ptr = std::shared_ptr<signal_type>;
+        using lock_type = std::unique_lock<Lockable>;
+        using index_type = std::unordered_map<Key, signal_ptr>;
+
+        static constexpr bool thread_safe = !std::is_same<Lockable, detail::null_mutex>::value;
+        using cow_index = std::conditional_t<thread_safe, detail::copy_on_write<index_type>, index_type>;
+        using cow_index_copy = std::conditional_t<thread_safe, detail::copy_on_write<index_type>, const index_type&>;
+
+    public:
+        using key_type = Key;
+
+        keyed_signal_base() noexcept : m_block(false) {}
+        ~keyed_signal_base() = default;
+
+        keyed_signal_base(const keyed_signal_base&) = delete;
+        keyed_signal_base& operator=(const keyed_signal_base&) = delete;
+
+        /**
+         * Emit a signal for a key
+         *          * Effect: All non blocked and connected slot functions of the key will be
+         *         called with supplied arguments.
+         * Safety: Same guarantees as signal_base emission.
+         *          * @param key the key whose slots are called
+         * @param a... arguments to emit
+         */
+        template <typename... U>
+        void operator()(const Key& key, U&& ...a) const {
+            if (m_block) {
+                return;
+            }
+
+            // the index shared by the emission keeps the signal alive
+            cow_index_copy ref = index_reference();
+            const auto& signals = detail::cow_read(ref);
+            auto it = signals.find(key);
+            if (it != signals.end()) {
+                (*it->second)(std::forward<U>(a)...);
+            }
+        }
+
+        /**
+         * Connect a slot for a key
+         * Use the same semantics as signal_base::connect for the remaining arguments.
+         *          * @param key the key whose emissions are delivered to the slot
+         * @return a connection object that can be used to interact with the slot
+         */
+        template <typename... CallArgs>
+        connection connect(const Key& key, CallArgs&& ...args) {
+            // connected under the lock, so that the signal is not pruned meanwhile
+            lock_type lock(m_mutex);
+            return channel(key)->connect(std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Creates a connection whose duration is tied to the return object
+         * Use the same semantics as connect
+         */
+        template <typename... CallArgs>
+        scoped_connection connect_scoped(const Key& key, CallArgs&& ...args) {
+            return connect(key, std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Disconnect all the slots of a key
+         * Safety: Thread-safety depends on locking policy.
+         *          * @return the number of disconnected slots
+         */
+        size_t disconnect(const Key& key) {
+            signal_ptr sig;
+            {
+                lock_type lock(m_mutex);
+                auto& signals = detail::cow_write(m_signals);
+                auto it = signals.find(key);
+                if (it == signals.end()) {
+                    return 0;
+                }
+                sig = std::move(it->second);
+                signals.erase(it);
+            }
+            const size_t count = sig->slot_count();
+            sig->disconnect_all();
+            return count;
+        }
+
+        /**
+         * Disconnects all the slots of every key
+         * Safety: Thread safety depends on locking policy
+         */
+        void disconnect_all() {
+            cow_index signals;
+            {
+                lock_type lock(m_mutex);
+                using std::swap;
+                swap(signals, m_signals);
+                m_swept = 0;
+            }
+            for (auto& s : detail::cow_read(signals)) {
+                s.second->disconnect_all();
+            }
+        }
+
+        /**
+         * Blocks signal emission for every key
+         * Safety: thread safe
+         */
+        void block() noexcept {
+            m_block.store(true);
+        }
+
+        /**
+         * Unblocks signal emission
+         * Safety: thread safe
+         */
+        void unblock() noexcept {
+            m_block.store(false);
+        }
+
+        /**
+         * Tests blocking state of signal emission
+         */
+        bool blocked() const noexcept {
+            return m_block.load();
+        }
+
+        /**
+         * Get number of connected slots for a key
+         * Safety: thread safe
+         */
+        size_t slot_count(const Key& key) const {
+            cow_index_copy ref = index_reference();
+            const auto& signals = detail::cow_read(ref);
+            auto it = signals.find(key);
+            return it != signals.end() ? it->second->slot_count() : 0;
+        }
+
+        /**
+         * Get number of keys in the index. Keys whose slots were all disconnected
+         * stay counted until they are pruned, at most as many as the keys
+         * having slots.
+         * Safety: thread safe
+         */
+        size_t key_count() const {
+            cow_index_copy ref = index_reference();
+            return detail::cow_read(ref).size();
+        }
+
+    private:
+        // used to get a reference to the index for reading
+        cow_index_copy index_reference() const {
+            lock_type lock(m_mutex);
+            return m_signals;
+        }
+
+        // the signal of a key, created if necessary, with the lock held
+        signal_ptr& channel(const Key& key) {
+            auto& signals = detail::cow_write(m_signals);
+            auto it = signals.find(key);
+            if (it != signals.end()) {
+                return it->second;
+            }
+            // the index doubled since the last sweep, amortized over the new keys
+            if (signals.size() >= std::max<std::size_t>(2 * m_swept, 16)) {
+                for (auto s = signals.begin(); s != signals.end();) {
+                    s = s->second->slot_count() == 0 ? signals.erase(s) : std::next(s);
+                }
+                m_swept = signals.size();
+            }
+            return signals.emplace(key, std::make_shared<signal_type>()).first->second;
+        }
+
+    private:
+        mutable Lockable m_mutex;
+        cow_index m_signals;
+        std::size_t m_swept = 0;    // size of the index after the last sweep
+        std::atomic<bool> m_block;
+    };
+
+    /**
+     * Specialization of keyed_signal_base to be used in single threaded contexts.
+     */
+    template <typename Key, typename... T>
+    using keyed_signal_st = keyed_signal_base<detail::null_mutex, Key, T...>;
+
+    /**
+     * Specialization of keyed_signal_base to be used in multi-threaded contexts.
+     */
+    template <typename Key, typename... T>
+    using keyed_signal = keyed_signal_base<std::mutex, Key, T...>;
+
+} // namespace sigslot
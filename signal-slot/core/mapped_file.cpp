@@ -0,0 +1,82 @@
+#include "mapped_file.hpp"
+
+#if defined(CORE_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+
+    MappedFile::MappedFile(std::string path, void* data, size_t size)
+    : path_(std::move(path)), data_(data), size_(size) {}
+
+#if defined(CORE_POSIX)
+
+    MappedFile::~MappedFile() {
+        munmap(data_, size_);
+    }
+
+    std::unique_ptr<MappedFile> MappedFile::Create(std::string_view path, size_t size) {
+        std::string file(path);
+        int fd = open(file.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (fd < 0) {
+            return nullptr;
+        }
+        // the file stays sparse until written
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            return nullptr;
+        }
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        return std::unique_ptr<MappedFile>(new MappedFile(std::move(file), data, size));
+    }
+
+    std::unique_ptr<MappedFile> MappedFile::Open(std::string_view path) {
+        std::string file(path);
+        int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return nullptr;
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        return std::unique_ptr<MappedFile>(new MappedFile(std::move(file), data, size));
+    }
+
+    bool MappedFile::Remove(std::string_view path) {
+        return unlink(std::string(path).c_str()) == 0;
+    }
+
+#else
+
+    MappedFile::~MappedFile() = default;
+
+    std::unique_ptr<MappedFile> MappedFile::Create(std::string_view, size_t) {
+        return nullptr;
+    }
+
+    std::unique_ptr<MappedFile> MappedFile::Open(std::string_view) {
+        return nullptr;
+    }
+
+    bool MappedFile::Remove(std::string_view) {
+        return false;
+    }
+
+#endif
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace core {
+
+    // A file mapped in the address space of the process with mmap, on POSIX
+    // systems. Not supported elsewhere, where Create and Open return nullptr.
+    //
+    // Writes to a mapping obtained with Create reach the file without system
+    // calls, and survive a crash of the process.
+    class MappedFile {
+    public:
+        ~MappedFile();
+
+        // Creates or truncates the file |path| to |size| zero bytes, mapped for
+        // reading and writing. Returns nullptr on failure.
+        static std::unique_ptr<MappedFile> Create(std::string_view path, size_t size);
+
+        // Maps an existing file for reading. Returns nullptr if it does not exist
+        // or is empty.
+        static std::unique_ptr<MappedFile> Open(std::string_view path);
+
+        // Removes the file |path|, returns false if it did not exist.
+        static bool Remove(std::string_view path);
+
+        void* Data() const { return data_; }
+        size_t Size() const { return size_; }
+        const std::string& Path() const { return path_; }
+
+    private:
+        MappedFile(std::string path, void* data, size_t size);
+
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(const MappedFile&) = delete;
+
+    private:
+        const std::string path_;
+        void* const data_;
+        const size_t size_;
+    };
+
+}
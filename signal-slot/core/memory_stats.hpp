@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "signal.hpp"
+
+namespace sigslot {
+
+    /**
+     * Live slots of a type, see memory_stats()
+     */
+    struct slot_memory_stats {
+        std::string type;                   // slot class, demangled where possible
+        memory_usage usage;
+    };
+
+    /**
+     * Tasks waiting in a task queue, see memory_stats()
+     */
+    struct queue_memory_stats {
+        std::string queue;
+        core::TaskQueueMemory usage;
+    };
+
+    /**
+     * Memory held by the signals, slots and task queues of the process
+     */
+    struct memory_report {
+        std::vector<slot_memory_stats> slots;       // by slot type, the largest first
+        memory_usage slot_lists;                    // slot vectors of the signals
+        memory_usage cow_payloads;                  // copy on write payloads holding them
+        std::uint64_t cow_copies = 0;               // payloads copied by writers since the start
+        memory_usage observers;                     // connection lists of the observers
+        memory_usage delayed_nodes;                 // delayed task map nodes of all the queues
+        std::vector<queue_memory_stats> queues;     // by queue, in creation order
+
+        /**
+         * Bytes accounted over all the categories
+         */
+        std::uint64_t total_bytes() const noexcept {
+            std::uint64_t total = slot_lists.bytes + cow_payloads.bytes + observers.bytes + delayed_nodes.bytes;
+            for (auto& s : slots) {
+                total += s.usage.bytes;
+            }
+            for (auto& q : queues) {
+                total += q.usage.pending_bytes + q.usage.delayed_bytes;
+            }
+            return total;
+        }
+
+        /**
+         * Text table of the categories, the queues and the top slot types
+         */
+        std::string report(std::size_t top = 20) const {
+            std::string out;
+            char line[256];
+            auto row = [&](const char *name, std::uint64_t objects, std::uint64_t bytes) {
+                std::snprintf(line, sizeof(line), "%-32.32s %12llu %14llu\n", name,
+                              static_cast<unsigned long long>(objects), static_cast<unsigned long long>(bytes));
+                out += line;
+            };
+
+            std::snprintf(line, sizeof(line), "%-32s %12s %14s\n", "CATEGORY", "OBJECTS", "BYTES");
+            out += line;
+            memory_usage all_slots;
+            for (auto& s : slots) {
+                all_slots.objects += s.usage.objects;
+                all_slots.bytes += s.usage.bytes;
+            }
+            row("slots", all_slots.objects, all_slots.bytes);
+            row("slot lists", slot_lists.objects, slot_lists.bytes);
+            row("cow payloads", cow_payloads.objects, cow_payloads.bytes);
+            row("observers", observers.objects, observers.bytes);
+            row("delayed nodes", delayed_nodes.objects, delayed_nodes.bytes);
+            std::snprintf(line, sizeof(line), "%-32s %12llu\n%-32s %27llu\n", "cow copies",
+                          static_cast<unsigned long long>(cow_copies), "total",
+                          static_cast<unsigned long long>(total_bytes()));
+            out += line;
+
+            std::snprintf(line, sizeof(line), "\n%-32s %12s %14s %12s %14s\n",
+                          "QUEUE", "PENDING", "PENDING BYTES", "DELAYED", "DELAYED BYTES");
+            out += line;
+            for (auto& q : queues) {
+                std::snprintf(line, sizeof(line), "%-32.32s %12zu %14zu %12zu %14zu\n", q.queue.c_str(),
+                              q.usage.pending_tasks, q.usage.pending_bytes, q.usage.delayed_tasks, q.usage.delayed_bytes);
+                out += line;
+            }
+
+            std::snprintf(line, sizeof(line), "\n%12s %14s  %s\n", "SLOTS", "BYTES", "TYPE");
+            out += line;
+            for (std::size_t i = 0; i < slots.size() && i < top; ++i) {
+                std::snprintf(line, sizeof(line), "%12llu %14llu  ",
+                              static_cast<unsigned long long>(slots[i].usage.objects),
+                              static_cast<unsigned long long>(slots[i].usage.bytes));
+                out += line;
+                out += slots[i].type + "\n";
+            }
+            return out;
+        }
+    };
+
+    /**
+     * Accounts the memory held by the library, to catch footprint regressions
+     * before they show in the RSS of the process. Slots, slot lists, copy on
+     * write payloads, observer connection lists and delayed task nodes are
+     * allocated through counting_allocator and counted as they come and go, at
+     * the cost of two relaxed atomic additions per allocation. Tasks waiting in
+     * the queues are walked under their lock, reporting their footprint with
+     * their captured arguments.
+     *
+     * Only the memory allocated by the library is accounted: memory owned by
+     * the callables or by the captured arguments, such as the buffer of a
+     * std::string, is not. Slots are counted with their shared pointer control
+     * block, except in SIGSLOT_REDUCE_COMPILE_TIME builds.
+     */
+    inline memory_report memory_stats() {
+        auto& registry = detail::memory_registry::instance();
+        memory_report r;
+
+        // a slot type may be registered once per shared library using it
+        std::map<std::string, memory_usage> slots;
+        for (auto& [type, usage] : registry.slot_usage()) {
+            if (usage.objects == 0) {
+                continue;
+            }
+            auto& s = slots[detail::demangle(type)];
+            s.objects += usage.objects;
+            s.bytes += usage.bytes;
+        }
+        for (auto& [type, usage] : slots) {
+            r.slots.push_back({type, usage});
+        }
+        std::sort(r.slots.begin(), r.slots.end(), [](const slot_memory_stats& a, const slot_memory_stats& b) {
+            return a.usage.bytes > b.usage.bytes;
+        });
+
+        r.slot_lists = registry.slot_lists.usage();
+        r.cow_payloads = registry.cow_payloads.usage();
+        r.cow_copies = registry.cow_copies.load(std::memory_order_relaxed);
+        r.observers = registry.observers.usage();
+        r.delayed_nodes = registry.delayed_nodes.usage();
+        for (auto& [name, usage] : core::TaskQueue::MemoryUsageOfAll()) {
+            r.queues.push_back({name, usage});
+        }
+        return r;
+    }
+
+} // namespace sigslot
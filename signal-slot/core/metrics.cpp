@@ -0,0 +1,409 @@
+#include "metrics.hpp"
+#include "shared_memory.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#if defined(CORE_POSIX)
+#include <unistd.h>
+#endif
+
+namespace core {
+
+    namespace {
+
+        constexpr uint64_t kRegionMagic = 0x5349474d45545231ULL;  // "SIGMETR1"
+        constexpr uint32_t kRegionVersion = 1;
+
+        // kind of an entry being set up or released, skipped by readers
+        constexpr uint32_t kClaimed = 0xffffffffu;
+
+        struct RegionHeader {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t entry_size;
+            uint64_t capacity;
+            uint64_t pid;
+        };
+
+        constexpr size_t kEntriesOffset = 64;
+        static_assert(sizeof(RegionHeader) <= kEntriesOffset, "region header too large");
+
+        struct Region {
+            std::unique_ptr<SharedMemory> memory;
+            std::atomic<MetricsEntry*> entries{nullptr};
+            size_t capacity = 0;
+            std::mutex mutex;
+        };
+
+        // Never destroyed: queues and signals owned by statics release their
+        // entry after the exit handlers ran, the mapping must outlive them. The
+        // segment name is removed at exit by UnlinkRegion().
+        Region& GetRegion() {
+            static auto* region = new Region;
+            return *region;
+        }
+
+        void UnlinkRegion() {
+            auto& region = GetRegion();
+            std::lock_guard<std::mutex> _{region.mutex};
+            region.memory->Unlink();
+        }
+
+        uint64_t CurrentPid() {
+#if defined(CORE_POSIX)
+            return static_cast<uint64_t>(getpid());
+#else
+            return 0;
+#endif
+        }
+
+        size_t BucketOf(std::chrono::nanoseconds duration) {
+            const auto us = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)) / 1000;
+            size_t bucket = 0;
+            for (uint64_t v = us; v != 0; v >>= 1) {
+                ++bucket;
+            }
+            return std::min(bucket, kMetricsBuckets - 1);
+        }
+
+        void CopyHistogram(const MetricsHistogram& from, MetricsHistogramSnapshot& to) {
+            for (size_t i = 0; i < kMetricsBuckets; ++i) {
+                to.buckets[i] = from.buckets[i].load(std::memory_order_relaxed);
+            }
+            to.count = from.count.load(std::memory_order_relaxed);
+            to.total_ns = from.total_ns.load(std::memory_order_relaxed);
+        }
+
+        void ResetHistogram(MetricsHistogram& h) {
+            for (auto& b : h.buckets) {
+                b.store(0, std::memory_order_relaxed);
+            }
+            h.count.store(0, std::memory_order_relaxed);
+            h.total_ns.store(0, std::memory_order_relaxed);
+        }
+
+        std::string EscapeLabel(const std::string& value) {
+            std::string result;
+            result.reserve(value.size());
+            for (char c : value) {
+                switch (c) {
+                case '\\': result += "\\\\"; break;
+                case '"': result += "\\\""; break;
+                case '\n': result += "\\n"; break;
+                default: result += c; break;
+                }
+            }
+            return result;
+        }
+
+        void AppendValue(std::string& out, const char* format, double value) {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), format, value);
+            out += buffer;
+        }
+
+        void AppendCounter(std::string& out, const std::vector<MetricsSnapshot>& entries, MetricsKind kind,
+                           const char* family, const char* type, const char* help,
+                           uint64_t MetricsSnapshot::*field) {
+            const char* label = kind == MetricsKind::kQueue ? "queue" : "signal";
+            const bool counter = std::strcmp(type, "counter") == 0;
+            out += std::string("# TYPE ") + family + " " + type + "\n";
+            out += std::string("# HELP ") + family + " " + help + "\n";
+            for (auto& e : entries) {
+                if (e.kind != kind) {
+                    continue;
+                }
+                out += std::string(family) + (counter ? "_total{" : "{") + label + "=\"" + EscapeLabel(e.name) + "\"} " +
+                       std::to_string(e.*field) + "\n";
+            }
+        }
+
+        void AppendHistogram(std::string& out, const std::vector<MetricsSnapshot>& entries, MetricsKind kind,
+                             const char* family, const char* help,
+                             MetricsHistogramSnapshot MetricsSnapshot::*field) {
+            const char* label = kind == MetricsKind::kQueue ? "queue" : "signal";
+            out += std::string("# TYPE ") + family + " histogram\n";
+            out += std::string("# HELP ") + family + " " + help + "\n";
+            for (auto& e : entries) {
+                if (e.kind != kind) {
+                    continue;
+                }
+                const auto& h = e.*field;
+                const std::string labels = std::string(label) + "=\"" + EscapeLabel(e.name) + "\"";
+                // counters of signal entries are not read atomically together,
+                // the count is derived from the buckets to stay consistent
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i + 1 < kMetricsBuckets; ++i) {
+                    cumulative += h.buckets[i];
+                    out += std::string(family) + "_bucket{" + labels + ",le=\"";
+                    AppendValue(out, "%g", std::ldexp(1e-6, static_cast<int>(i)));
+                    out += "\"} " + std::to_string(cumulative) + "\n";
+                }
+                cumulative += h.buckets[kMetricsBuckets - 1];
+                out += std::string(family) + "_bucket{" + labels + ",le=\"+Inf\"} " + std::to_string(cumulative) + "\n";
+                out += std::string(family) + "_count{" + labels + "} " + std::to_string(cumulative) + "\n";
+                out += std::string(family) + "_sum{" + labels + "} ";
+                AppendValue(out, "%.9f", static_cast<double>(h.total_ns) / 1e9);
+                out += "\n";
+            }
+        }
+
+    }  // namespace
+
+    void MetricsHistogram::Record(std::chrono::nanoseconds duration) {
+        buckets[BucketOf(duration)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        total_ns.fetch_add(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)), std::memory_order_relaxed);
+    }
+
+    std::chrono::microseconds MetricsHistogramSnapshot::Percentile(double p) const {
+        uint64_t total = 0;
+        for (auto b : buckets) {
+            total += b;
+        }
+        if (total == 0) {
+            return std::chrono::microseconds(0);
+        }
+        const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * static_cast<double>(total))));
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < kMetricsBuckets; ++i) {
+            cumulative += buckets[i];
+            if (cumulative >= target) {
+                return std::chrono::microseconds(uint64_t{1} << i);
+            }
+        }
+        return std::chrono::microseconds(uint64_t{1} << (kMetricsBuckets - 1));
+    }
+
+    bool Metrics::Enable(std::string_view name, size_t capacity) {
+        auto& region = GetRegion();
+        std::lock_guard<std::mutex> _{region.mutex};
+        if (region.memory || capacity == 0) {
+            return false;
+        }
+        const std::string region_name = name.empty() ? DefaultRegionName(CurrentPid()) : std::string(name);
+        auto memory = SharedMemory::Create(region_name, kEntriesOffset + capacity * sizeof(MetricsEntry));
+        if (!memory) {
+            return false;
+        }
+
+        // the segment is zero filled: every entry is free with an even sequence
+        auto* header = new (memory->Data()) RegionHeader;
+        header->version = kRegionVersion;
+        header->entry_size = static_cast<uint32_t>(sizeof(MetricsEntry));
+        header->capacity = capacity;
+        header->pid = CurrentPid();
+        auto* entries = reinterpret_cast<MetricsEntry*>(static_cast<unsigned char*>(memory->Data()) + kEntriesOffset);
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = kRegionMagic;
+
+        region.capacity = capacity;
+        region.memory = std::move(memory);
+        region.entries.store(entries, std::memory_order_release);
+        std::atexit(UnlinkRegion);
+        return true;
+    }
+
+    bool Metrics::Enabled() {
+        return GetRegion().entries.load(std::memory_order_acquire) != nullptr;
+    }
+
+    std::string Metrics::RegionName() {
+        auto& region = GetRegion();
+        std::lock_guard<std::mutex> _{region.mutex};
+        if (!region.memory) {
+            return {};
+        }
+        // SharedMemory names carry the leading slash of shm_open
+        const auto& name = region.memory->Name();
+        return name.empty() || name.front() != '/' ? name : name.substr(1);
+    }
+
+    std::string Metrics::DefaultRegionName(uint64_t pid) {
+        return "sigslot_metrics_" + std::to_string(pid);
+    }
+
+    std::vector<MetricsSnapshot> Metrics::Read(const void* data, size_t size) {
+        std::vector<MetricsSnapshot> result;
+        if (!data || size < kEntriesOffset) {
+            return result;
+        }
+        const auto* header = static_cast<const RegionHeader*>(data);
+        if (header->magic != kRegionMagic || header->version != kRegionVersion ||
+            header->entry_size != sizeof(MetricsEntry) ||
+            header->capacity > (size - kEntriesOffset) / sizeof(MetricsEntry)) {
+            return result;
+        }
+
+        // the region is only read, the entries are not const to load their atomics
+        auto* entries = reinterpret_cast<MetricsEntry*>(const_cast<unsigned char*>(
+            static_cast<const unsigned char*>(data) + kEntriesOffset));
+        for (size_t i = 0; i < header->capacity; ++i) {
+            auto& entry = entries[i];
+            if (entry.kind.load(std::memory_order_relaxed) == static_cast<uint32_t>(MetricsKind::kFree)) {
+                continue;
+            }
+
+            // seqlock read, retried while a writer is active; an entry left odd
+            // by a crashed writer is taken as is after a few attempts
+            MetricsSnapshot s;
+            uint32_t kind = 0;
+            for (int attempt = 0; attempt < 64; ++attempt) {
+                const uint32_t begin = entry.seq.load(std::memory_order_acquire);
+                if ((begin & 1) && attempt + 1 < 64) {
+                    continue;
+                }
+                kind = entry.kind.load(std::memory_order_relaxed);
+                char name[sizeof(entry.name)];
+                std::memcpy(name, entry.name, sizeof(name));
+                name[sizeof(name) - 1] = '\0';
+                s.name = name;
+                s.depth = entry.depth.load(std::memory_order_relaxed);
+                s.count = entry.count.load(std::memory_order_relaxed);
+                s.drops = entry.drops.load(std::memory_order_relaxed);
+                s.deliveries = entry.deliveries.load(std::memory_order_relaxed);
+                CopyHistogram(entry.wait, s.wait);
+                CopyHistogram(entry.run, s.run);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (entry.seq.load(std::memory_order_relaxed) == begin) {
+                    break;
+                }
+            }
+            if (kind != static_cast<uint32_t>(MetricsKind::kQueue) && kind != static_cast<uint32_t>(MetricsKind::kSignal)) {
+                continue;
+            }
+            s.kind = static_cast<MetricsKind>(kind);
+            result.push_back(std::move(s));
+        }
+        return result;
+    }
+
+    std::vector<MetricsSnapshot> Metrics::Snapshot() {
+        auto& region = GetRegion();
+        std::lock_guard<std::mutex> _{region.mutex};
+        if (!region.memory) {
+            return {};
+        }
+        return Read(region.memory->Data(), region.memory->Size());
+    }
+
+    std::string Metrics::FormatOpenMetrics(const std::vector<MetricsSnapshot>& entries) {
+        std::string out;
+        AppendCounter(out, entries, MetricsKind::kQueue, "sigslot_queue_depth", "gauge",
+                      "Tasks pending after the last task run.", &MetricsSnapshot::depth);
+        AppendCounter(out, entries, MetricsKind::kQueue, "sigslot_queue_tasks", "counter",
+                      "Tasks run.", &MetricsSnapshot::count);
+        AppendHistogram(out, entries, MetricsKind::kQueue, "sigslot_queue_wait_seconds",
+                        "Time from when a task is due to when it starts.", &MetricsSnapshot::wait);
+        AppendHistogram(out, entries, MetricsKind::kQueue, "sigslot_queue_run_seconds",
+                        "Run time of the tasks.", &MetricsSnapshot::run);
+        AppendCounter(out, entries, MetricsKind::kSignal, "sigslot_signal_emissions", "counter",
+                      "Emissions.", &MetricsSnapshot::count);
+        AppendCounter(out, entries, MetricsKind::kSignal, "sigslot_signal_deliveries", "counter",
+                      "Slots called or posted to.", &MetricsSnapshot::deliveries);
+        AppendCounter(out, entries, MetricsKind::kSignal, "sigslot_signal_drops", "counter",
+                      "Emissions that reached no slot.", &MetricsSnapshot::drops);
+        AppendHistogram(out, entries, MetricsKind::kSignal, "sigslot_signal_emit_seconds",
+                        "Time spent emitting.", &MetricsSnapshot::run);
+        out += "# EOF\n";
+        return out;
+    }
+
+    bool Metrics::DumpOpenMetrics(const std::string& path) {
+        // written aside and renamed, so that a scraper never reads a partial file
+        const std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return false;
+            }
+            file << FormatOpenMetrics(Snapshot());
+            if (!file.flush()) {
+                std::remove(temp.c_str());
+                return false;
+            }
+        }
+        if (std::rename(temp.c_str(), path.c_str()) != 0) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    MetricsHandle::~MetricsHandle() {
+        Release();
+    }
+
+    MetricsHandle::MetricsHandle(MetricsHandle&& o) noexcept
+    : entry_(o.entry_) {
+        o.entry_ = nullptr;
+    }
+
+    MetricsHandle& MetricsHandle::operator=(MetricsHandle&& o) noexcept {
+        if (this != &o) {
+            Release();
+            entry_ = o.entry_;
+            o.entry_ = nullptr;
+        }
+        return *this;
+    }
+
+    MetricsHandle MetricsHandle::Acquire(MetricsKind kind, std::string_view name) {
+        auto& region = GetRegion();
+        auto* entries = region.entries.load(std::memory_order_acquire);
+        if (!entries || kind == MetricsKind::kFree) {
+            return MetricsHandle();
+        }
+        for (size_t i = 0; i < region.capacity; ++i) {
+            auto& entry = entries[i];
+            uint32_t expected = static_cast<uint32_t>(MetricsKind::kFree);
+            if (!entry.kind.compare_exchange_strong(expected, kClaimed, std::memory_order_acquire)) {
+                continue;
+            }
+            MetricsHandle handle(&entry);
+            handle.BeginWrite();
+            const size_t length = std::min(name.size(), sizeof(entry.name) - 1);
+            std::memset(entry.name, 0, sizeof(entry.name));
+            std::memcpy(entry.name, name.data(), length);
+            entry.depth.store(0, std::memory_order_relaxed);
+            entry.count.store(0, std::memory_order_relaxed);
+            entry.drops.store(0, std::memory_order_relaxed);
+            entry.deliveries.store(0, std::memory_order_relaxed);
+            ResetHistogram(entry.wait);
+            ResetHistogram(entry.run);
+            entry.kind.store(static_cast<uint32_t>(kind), std::memory_order_relaxed);
+            handle.EndWrite();
+            return handle;
+        }
+        return MetricsHandle();
+    }
+
+    void MetricsHandle::BeginWrite() {
+        entry_->seq.store(entry_->seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void MetricsHandle::EndWrite() {
+        entry_->seq.store(entry_->seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void MetricsHandle::Release() {
+        if (!entry_) {
+            return;
+        }
+        BeginWrite();
+        entry_->kind.store(kClaimed, std::memory_order_relaxed);
+        EndWrite();
+        // free only once the entry is no longer visible as in use
+        entry_->kind.store(static_cast<uint32_t>(MetricsKind::kFree), std::memory_order_release);
+        entry_ = nullptr;
+    }
+
+}
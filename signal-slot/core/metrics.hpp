@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core {
+
+    // Histograms count durations in power of two buckets: bucket i holds the
+    // durations shorter than 2^i microseconds, the last one the longer ones.
+    constexpr size_t kMetricsBuckets = 24;
+
+    struct MetricsHistogram {
+        std::atomic<uint64_t> buckets[kMetricsBuckets];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> total_ns;
+
+        void Record(std::chrono::nanoseconds duration);
+    };
+
+    enum class MetricsKind : uint32_t { kFree = 0, kQueue = 1, kSignal = 2 };
+
+    // An entry of the stats region, in shared memory.
+    //
+    // Queue entries are updated by the task running on the queue, one at a
+    // time, under the seqlock |seq| (odd while written), so that readers get
+    // consistent snapshots. Signal entries are updated by the emitting threads
+    // with atomic increments, each counter being consistent on its own.
+    struct MetricsEntry {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint32_t> kind;
+        char name[56];
+
+        std::atomic<uint64_t> depth;        // queue: tasks pending after the last run
+        std::atomic<uint64_t> count;        // queue: tasks run, signal: emissions
+        std::atomic<uint64_t> drops;        // signal: emissions that reached no slot
+        std::atomic<uint64_t> deliveries;   // signal: slots called or posted
+        MetricsHistogram wait;              // queue: time from due to run
+        MetricsHistogram run;               // queue: run time, signal: emission time
+    };
+
+    // A copy of a histogram, see MetricsHistogram.
+    struct MetricsHistogramSnapshot {
+        std::array<uint64_t, kMetricsBuckets> buckets{};
+        uint64_t count = 0;
+        uint64_t total_ns = 0;
+
+        // Upper bound of the bucket holding the |p| quantile, 0 < p <= 1.
+        std::chrono::microseconds Percentile(double p) const;
+    };
+
+    // A consistent copy of an entry, see Metrics::Read.
+    struct MetricsSnapshot {
+        MetricsKind kind = MetricsKind::kFree;
+        std::string name;
+        uint64_t depth = 0;
+        uint64_t count = 0;
+        uint64_t drops = 0;
+        uint64_t deliveries = 0;
+        MetricsHistogramSnapshot wait;
+        MetricsHistogramSnapshot run;
+    };
+
+    // Process wide stats region, a shared memory segment that an external tool
+    // such as sigslot_top maps to watch the queues and the instrumented signals
+    // of the process, without any cooperation from it.
+    //
+    // Metrics are off until Enable is called. Task queues created afterwards
+    // record their depth and the wait and run times of their tasks, see
+    // TaskQueue, and signals record their emissions once instrumented, see
+    // signal_base::instrument().
+    class Metrics {
+    public:
+        // Creates the stats region |name|, or "sigslot_metrics_<pid>" if empty,
+        // with room for |capacity| entries. Returns false on failure or if the
+        // region already exists.
+        static bool Enable(std::string_view name = {}, size_t capacity = 256);
+        static bool Enabled();
+
+        // Name of the stats region of this process, empty when disabled.
+        static std::string RegionName();
+
+        // Default region name of the process |pid|.
+        static std::string DefaultRegionName(uint64_t pid);
+
+        // Reads the entries in use of a stats region mapped at |region|, by
+        // this process or by another one. Returns nothing if it is not a region.
+        static std::vector<MetricsSnapshot> Read(const void* region, size_t size);
+
+        // Reads the entries of the stats region of this process.
+        static std::vector<MetricsSnapshot> Snapshot();
+
+        // Formats entries in the OpenMetrics text format.
+        static std::string FormatOpenMetrics(const std::vector<MetricsSnapshot>& entries);
+
+        // Writes the entries of this process to |path| in the OpenMetrics text
+        // format. Returns false on failure.
+        static bool DumpOpenMetrics(const std::string& path);
+    };
+
+    // Entry of the stats region owned by a queue or a signal, freed with it.
+    class MetricsHandle {
+    public:
+        MetricsHandle() = default;
+        ~MetricsHandle();
+
+        MetricsHandle(MetricsHandle&& o) noexcept;
+        MetricsHandle& operator=(MetricsHandle&& o) noexcept;
+
+        // Returns an empty handle if metrics are off or the region is full.
+        static MetricsHandle Acquire(MetricsKind kind, std::string_view name);
+
+        explicit operator bool() const { return entry_ != nullptr; }
+        MetricsEntry* operator->() const { return entry_; }
+
+        // Seqlock of queue entries, brackets updates from the single writer.
+        void BeginWrite();
+        void EndWrite();
+
+    private:
+        explicit MetricsHandle(MetricsEntry* entry) : entry_(entry) {}
+
+        MetricsHandle& operator=(const MetricsHandle&) = delete;
+        MetricsHandle(const MetricsHandle&) = delete;
+
+        void Release();
+
+    private:
+        MetricsEntry* entry_ = nullptr;
+    };
+
+}
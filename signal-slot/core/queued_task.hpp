@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
 #include <memory>
 
@@ -18,6 +19,18 @@ namespace core {
         // having been transferred.  Returning |false| can be useful if a task has
         // re-posted itself to a different queue or is otherwise being re-used.
         virtual bool run() = 0;
+
+        // Opaque identifier of the owner of the task, allowing to drop all the
+        // pending tasks of an owner at once with TaskQueueBase::PurgeTasks().
+        const void* tag() const { return tag_; }
+        void set_tag(const void* tag) { tag_ = tag; }
+
+        // Bytes held by the task, its captures included, for the memory
+        // accounting of the queues. Memory owned by the captures is not known.
+        virtual size_t footprint() const { return sizeof(QueuedTask); }
+
+    private:
+        const void* tag_ = nullptr;
     };
 
     // Simple implementation of QueuedTask for use with rtc::Bind and lambdas.
@@ -27,6 +40,8 @@ namespace core {
         explicit ClosureTask(Closure&& closure)
         : closure_(std::forward<Closure>(closure)) {}
 
+        size_t footprint() const override { return sizeof(*this); }
+
     private:
         bool run() override {
             closure_();
@@ -52,6 +67,8 @@ namespace core {
         , cleanup_(std::forward<Cleanup>(cleanup)) {}
         ~ClosureTaskWithCleanup() override { cleanup_(); }
 
+        size_t footprint() const override { return sizeof(*this); }
+
     private:
         typename std::decay<Cleanup>::type cleanup_;
     };
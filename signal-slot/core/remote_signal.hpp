@@ -0,0 +1,380 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "signal.hpp"
+#include "codec.hpp"
+#include "unix_socket.hpp"
+
+namespace sigslot {
+
+    /**
+     * Batching settings of a remote_sender.
+     *      * Emissions are written by batches from the writer queue: a batch is sent
+     * once the writer is free, or right away once it holds max_batch_bytes. With
+     * a non zero max_delay, a batch is held up to that long to let it grow, in
+     * the spirit of Nagle's algorithm, trading latency for fewer system calls.
+     */
+    struct remote_options {
+        std::size_t max_batch_bytes = 64 * 1024;
+        std::chrono::milliseconds max_delay{0};
+    };
+
+    namespace detail {
+
+        // emissions travel as frames made of a 32 bits length and the arguments
+        using remote_frame_size = std::uint32_t;
+
+        /*
+         * Shared state of a remote_sender, kept alive by pending flush tasks.
+         * Frames are appended to chunks, sent with one vectored write per batch.
+         */
+        class remote_sender_state : public std::enable_shared_from_this<remote_sender_state> {
+            using chunk = std::vector<unsigned char>;
+
+        public:
+            remote_sender_state(int fd, core::TaskQueue *writer, const remote_options& options)
+            : m_fd(fd)
+            , m_writer(writer)
+            , m_options(options)
+            {}
+
+            ~remote_sender_state() {
+                core::CloseSocket(m_fd);
+            }
+
+            // reserve room for a frame of size bytes in the current batch and
+            // call encode on it
+            template <typename Encode>
+            bool append(std::size_t size, Encode&& encode) {
+                if (m_broken) {
+                    return false;
+                }
+                const std::size_t frame = sizeof(remote_frame_size) + size;
+
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_batch.empty() || m_batch.back().size() + frame > m_batch.back().capacity()) {
+                    m_batch.push_back(take_chunk(frame));
+                }
+                auto& c = m_batch.back();
+                const auto offset = c.size();
+                c.resize(offset + frame);
+                const auto length = static_cast<remote_frame_size>(size);
+                std::memcpy(c.data() + offset, &length, sizeof(length));
+                encode(c.data() + offset + sizeof(length));
+                m_bytes += frame;
+                ++m_frames;
+
+                const bool full = m_bytes >= m_options.max_batch_bytes;
+                if (full && !m_flush_now) {
+                    m_flush_now = true;
+                    lock.unlock();
+                    post_flush(std::chrono::milliseconds(0));
+                } else if (!m_flush_pending) {
+                    m_flush_pending = true;
+                    lock.unlock();
+                    post_flush(m_options.max_delay);
+                }
+                return true;
+            }
+
+            void flush() {
+                post_flush(std::chrono::milliseconds(0));
+            }
+
+            bool broken() const noexcept {
+                return m_broken;
+            }
+
+            std::uint64_t frames() const noexcept {
+                return m_frames;
+            }
+
+            std::uint64_t writes() const noexcept {
+                return m_writes;
+            }
+
+        private:
+            chunk take_chunk(std::size_t min) {
+                chunk c;
+                if (!m_free.empty()) {
+                    c = std::move(m_free.back());
+                    m_free.pop_back();
+                    c.clear();
+                }
+                c.reserve(std::max(min, std::max<std::size_t>(m_options.max_batch_bytes, 4096)));
+                return c;
+            }
+
+            void post_flush(std::chrono::milliseconds delay) {
+                auto task = [self = shared_from_this()]() { self->write_batch(); };
+                if (delay.count() > 0) {
+                    m_writer->PostDelayedTask(std::move(task), delay);
+                } else {
+                    m_writer->PostTask(std::move(task));
+                }
+            }
+
+            // runs on the writer queue
+            void write_batch() {
+                std::vector<chunk> batch;
+                {
+                    std::lock_guard<std::mutex> _{m_mutex};
+                    batch.swap(m_batch);
+                    m_bytes = 0;
+                    m_flush_pending = false;
+                    m_flush_now = false;
+                }
+                if (batch.empty()) {
+                    return;
+                }
+
+                std::vector<core::IoSlice> slices;
+                slices.reserve(batch.size());
+                for (auto& c : batch) {
+                    slices.push_back({c.data(), c.size()});
+                }
+                if (!m_broken && !core::WriteVectored(m_fd, slices.data(), slices.size())) {
+                    m_broken = true;
+                }
+                ++m_writes;
+
+                std::lock_guard<std::mutex> _{m_mutex};
+                for (auto& c : batch) {
+                    if (m_free.size() < 4) {
+                        m_free.push_back(std::move(c));
+                    }
+                }
+            }
+
+        private:
+            const int m_fd;
+            core::TaskQueue *const m_writer;
+            const remote_options m_options;
+
+            std::mutex m_mutex;
+            std::vector<chunk> m_batch;
+            std::vector<chunk> m_free;
+            std::size_t m_bytes = 0;
+            bool m_flush_pending = false;
+            bool m_flush_now = false;
+
+            std::atomic<bool> m_broken{false};
+            std::atomic<std::uint64_t> m_frames{0};
+            std::atomic<std::uint64_t> m_writes{0};
+        };
+
+    } // namespace detail
+
+    /**
+     * remote_sender sends emissions over a connected stream socket, typically a
+     * Unix domain socket, to a remote_receiver in another process.
+     *      * Emitting only appends a frame to the current batch, the socket is written
+     * from the writer queue, one vectored write per batch, see remote_options.
+     * Arguments are encoded with codec<T...>, see codec_traits.
+     *      * @tparam T... the argument types of the emitting and slots functions.
+     */
+    template <typename... T>
+    class remote_sender {
+        using codec_type = codec<T...>;
+
+    public:
+        /**
+         * @param fd a connected stream socket, owned by the sender
+         * @param writer the queue writing to the socket
+         */
+        remote_sender(int fd, core::TaskQueue *writer, const remote_options& options = {})
+        : m_state(std::make_shared<detail::remote_sender_state>(fd, writer, options))
+        {
+            assert(writer);
+        }
+
+        remote_sender(const remote_sender&) = delete;
+        remote_sender& operator=(const remote_sender&) = delete;
+
+        /**
+         * Send an emission, returns false once the connection is broken
+         */
+        bool operator()(const std::decay_t<T>& ...a) {
+            return m_state->append(codec_type::size(a...), [&](unsigned char *p) {
+                codec_type::encode(p, a...);
+            });
+        }
+
+        /**
+         * Send the emissions of a signal, from the emitting thread
+         */
+        template <typename Lockable>
+        connection attach(signal_base<Lockable, T...>& sig) {
+            return sig.connect([state = m_state](const std::decay_t<T>& ...a) {
+                state->append(codec_type::size(a...), [&](unsigned char *p) {
+                    codec_type::encode(p, a...);
+                });
+            });
+        }
+
+        /**
+         * Write the current batch without waiting for max_delay
+         */
+        void flush() {
+            m_state->flush();
+        }
+
+        bool broken() const noexcept {
+            return m_state->broken();
+        }
+
+        // number of emissions sent and of writes used to send them
+        std::uint64_t frames() const noexcept { return m_state->frames(); }
+        std::uint64_t writes() const noexcept { return m_state->writes(); }
+
+    private:
+        std::shared_ptr<detail::remote_sender_state> m_state;
+    };
+
+    /**
+     * remote_receiver reads the emissions of a remote_sender from a connected
+     * stream socket and re-emits them on a local signal.
+     *      * The socket is watched by a task queue supporting file descriptors, see
+     * core::TaskQueue::CreateEpoll(), and the local signal is emitted from it.
+     *      * @tparam T... the argument types of the emitting and slots functions.
+     */
+    template <typename... T>
+    class remote_receiver {
+        using codec_type = codec<T...>;
+        using frame_size = detail::remote_frame_size;
+
+    public:
+        /**
+         * @param fd a connected stream socket, owned by the receiver
+         * @param queue the queue watching the socket, created with CreateEpoll()
+         * @param max_frame larger frames are taken as malformed
+         */
+        remote_receiver(int fd, core::TaskQueue *queue, std::size_t max_frame = 16 * 1024 * 1024)
+        : m_fd(fd)
+        , m_queue(queue)
+        , m_max_frame(max_frame)
+        , m_buffer(64 * 1024)
+        {
+            assert(queue);
+            core::SetNonBlocking(m_fd);
+            m_watching = m_queue->WatchReadable(m_fd, [this]() { on_readable(); });
+            assert(m_watching && "the queue must support file descriptors");
+        }
+
+        ~remote_receiver() {
+            unwatch();
+            core::CloseSocket(m_fd);
+        }
+
+        remote_receiver(const remote_receiver&) = delete;
+        remote_receiver& operator=(const remote_receiver&) = delete;
+
+        signal<T...>& local() noexcept {
+            return m_local;
+        }
+
+        /**
+         * Connect a slot to the local signal, see signal_base::connect
+         */
+        template <typename... CallArgs>
+        connection connect(CallArgs&& ...args) {
+            return m_local.connect(std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * true once the sender closed the connection or sent a malformed frame
+         */
+        bool closed() const noexcept {
+            return m_closed;
+        }
+
+    private:
+        // stop watching the socket, from the queue so that no callback is running
+        void unwatch() {
+            if (!m_watching) {
+                return;
+            }
+            if (m_queue->IsCurrent()) {
+                m_queue->UnwatchReadable(m_fd);
+            } else {
+                std::promise<void> done;
+                m_queue->PostTask([this, &done]() {
+                    m_queue->UnwatchReadable(m_fd);
+                    done.set_value();
+                });
+                done.get_future().wait();
+            }
+            m_watching = false;
+        }
+
+        // runs on the queue, reads what is available and emits complete frames
+        void on_readable() {
+            for (;;) {
+                if (m_end == m_buffer.size()) {
+                    m_buffer.resize(m_buffer.size() * 2);
+                }
+                const long n = core::ReadSome(m_fd, m_buffer.data() + m_end, m_buffer.size() - m_end);
+                if (n == core::kReadWouldBlock) {
+                    break;
+                }
+                if (n <= 0) {
+                    close_connection();
+                    return;
+                }
+                m_end += static_cast<std::size_t>(n);
+                if (!emit_frames()) {
+                    close_connection();
+                    return;
+                }
+            }
+        }
+
+        bool emit_frames() {
+            std::size_t pos = 0;
+            while (m_end - pos >= sizeof(frame_size)) {
+                frame_size size;
+                std::memcpy(&size, m_buffer.data() + pos, sizeof(size));
+                if (size > m_max_frame || (codec_type::is_fixed_size && size != codec_type::fixed_size())) {
+                    return false;
+                }
+                if (m_end - pos - sizeof(size) < size) {
+                    break;
+                }
+                if (!codec_type::decode(m_buffer.data() + pos + sizeof(size), size, m_local)) {
+                    return false;
+                }
+                pos += sizeof(size) + size;
+            }
+            std::memmove(m_buffer.data(), m_buffer.data() + pos, m_end - pos);
+            m_end -= pos;
+            return true;
+        }
+
+        void close_connection() {
+            m_closed = true;
+            m_queue->UnwatchReadable(m_fd);
+            m_watching = false;
+        }
+
+    private:
+        const int m_fd;
+        core::TaskQueue *const m_queue;
+        const std::size_t m_max_frame;
+        std::vector<unsigned char> m_buffer;
+        std::size_t m_end = 0;
+        signal<T...> m_local;
+        std::atomic<bool> m_closed{false};
+        std::atomic<bool> m_watching{false};
+    };
+
+} // namespace sigslot
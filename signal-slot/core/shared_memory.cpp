@@ -0,0 +1,134 @@
+#include "shared_memory.hpp"
+#include <algorithm>
+#include <thread>
+
+#if defined(CORE_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace core {
+
+    namespace {
+
+        // shm_open names must start with a single slash
+        std::string SegmentName(std::string_view name) {
+            std::string result(name);
+            if (result.empty() || result.front() != '/') {
+                result.insert(result.begin(), '/');
+            }
+            return result;
+        }
+
+    }  // namespace
+
+    SharedMemory::SharedMemory(std::string name, void* data, size_t size, bool owner)
+    : name_(std::move(name)), data_(data), size_(size), owner_(owner) {}
+
+#if defined(CORE_POSIX)
+
+    SharedMemory::~SharedMemory() {
+        munmap(data_, size_);
+        Unlink();
+    }
+
+    void SharedMemory::Unlink() {
+        if (owner_) {
+            shm_unlink(name_.c_str());
+            owner_ = false;
+        }
+    }
+
+    std::unique_ptr<SharedMemory> SharedMemory::Create(std::string_view name, size_t size) {
+        auto segment = SegmentName(name);
+        shm_unlink(segment.c_str());
+
+        int fd = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            return nullptr;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            shm_unlink(segment.c_str());
+            return nullptr;
+        }
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            shm_unlink(segment.c_str());
+            return nullptr;
+        }
+        return std::unique_ptr<SharedMemory>(new SharedMemory(std::move(segment), data, size, true));
+    }
+
+    std::unique_ptr<SharedMemory> SharedMemory::Open(std::string_view name) {
+        auto segment = SegmentName(name);
+        int fd = shm_open(segment.c_str(), O_RDWR, 0600);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return nullptr;
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        return std::unique_ptr<SharedMemory>(new SharedMemory(std::move(segment), data, size, false));
+    }
+
+#else
+
+    SharedMemory::~SharedMemory() = default;
+
+    void SharedMemory::Unlink() {}
+
+    std::unique_ptr<SharedMemory> SharedMemory::Create(std::string_view, size_t) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedMemory> SharedMemory::Open(std::string_view) {
+        return nullptr;
+    }
+
+#endif
+
+#if defined(__linux__)
+
+    void WaitOnAddress(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::milliseconds timeout) {
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+        // not FUTEX_PRIVATE_FLAG, the word may be shared with other processes
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+    }
+
+    void WakeAddress(std::atomic<uint32_t>* word) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+    }
+
+#else
+
+    void WaitOnAddress(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::milliseconds timeout) {
+        if (word->load() == expected) {
+            std::this_thread::sleep_for(std::min(timeout, std::chrono::milliseconds(1)));
+        }
+    }
+
+    void WakeAddress(std::atomic<uint32_t>*) {}
+
+#endif
+
+}
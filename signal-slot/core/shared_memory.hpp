@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace core {
+
+    // A named shared memory segment mapped in the address space of the process,
+    // backed by POSIX shm_open on POSIX systems. Not supported elsewhere, where
+    // Create and Open return nullptr.
+    //
+    // The segment created by Create is unlinked when that object is destroyed.
+    // Mappings obtained with Open stay valid until they are destroyed.
+    class SharedMemory {
+    public:
+        ~SharedMemory();
+
+        // Creates a zero filled segment of |size| bytes, replacing any segment of
+        // the same name. Returns nullptr on failure.
+        static std::unique_ptr<SharedMemory> Create(std::string_view name, size_t size);
+
+        // Maps an existing segment. Returns nullptr if it does not exist.
+        static std::unique_ptr<SharedMemory> Open(std::string_view name);
+
+        void* Data() const { return data_; }
+        size_t Size() const { return size_; }
+        const std::string& Name() const { return name_; }
+
+        // Removes the name of a segment created by Create, other processes can
+        // no longer open it. The mapping stays valid until destroyed.
+        void Unlink();
+
+    private:
+        SharedMemory(std::string name, void* data, size_t size, bool owner);
+
+        SharedMemory& operator=(const SharedMemory&) = delete;
+        SharedMemory(const SharedMemory&) = delete;
+
+    private:
+        const std::string name_;
+        void* const data_;
+        const size_t size_;
+        bool owner_;
+    };
+
+    // Blocks while |*word| equals |expected|, until woken by WakeAddress from any
+    // process mapping the word, or until |timeout| elapsed. May return spuriously.
+    // Uses futexes on Linux, and a short sleep elsewhere.
+    void WaitOnAddress(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::milliseconds timeout);
+
+    // Wakes the threads blocked in WaitOnAddress on |word|, in any process.
+    void WakeAddress(std::atomic<uint32_t>* word);
+
+}
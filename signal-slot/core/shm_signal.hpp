@@ -0,0 +1,323 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "signal.hpp"
+#include "codec.hpp"
+#include "shared_memory.hpp"
+
+namespace sigslot {
+
+    namespace detail {
+
+        /*
+         * Header of the shared memory segment of a shm_signal, followed by the
+         * cells of a bounded multi producer, single consumer ring. Each cell holds
+         * a sequence number telling whether it is free or filled, then the
+         * arguments of an emission.
+         */
+        struct shm_ring_header {
+            static constexpr std::uint64_t magic_value = 0x53494753484d3031ULL;  // "SIGSHM01"
+            static constexpr std::size_t cache_line = 64;
+            static constexpr std::size_t payload_offset = 16;
+
+            std::uint64_t magic;
+            std::uint64_t signature;
+            std::uint64_t capacity;
+            std::uint64_t cell_size;
+            std::atomic<std::uint32_t> receiver{0};   // 1 while a process drains the ring
+
+            alignas(cache_line) std::atomic<std::uint64_t> enqueue_pos{0};
+            alignas(cache_line) std::atomic<std::uint64_t> dequeue_pos{0};
+            alignas(cache_line) std::atomic<std::uint32_t> wake_seq{0};
+            std::atomic<std::uint32_t> waiting{0};
+        };
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                      std::atomic<std::uint32_t>::is_always_lock_free,
+                      "shm_signal needs address free atomics");
+
+    } // namespace detail
+
+    /**
+     * shm_signal carries emissions from one process to another on the same
+     * host, through a lock-free ring in a POSIX shared memory segment.
+     *      * One process creates the segment, and re-emits the emissions found in the
+     * ring on a local signal from a task queue, see start() and connect(). Any
+     * number of threads, in any number of processes having opened the segment,
+     * may emit. A receiving thread sleeps on a futex in the segment while the
+     * ring is empty and wakes up the queue when emissions arrive, so idle rings
+     * cost nothing and emitters only make a system call when the receiver sleeps.
+     *      * Arguments are encoded in the ring with codec<T...>, their encoding must have
+     * a fixed size, as for trivially copyable types, and both processes must be
+     * built with the same types.
+     *      * @tparam T... the argument types of the emitting and slots functions.
+     */
+    template <typename... T>
+    class shm_signal {
+        using codec_type = codec<T...>;
+        using header_type = detail::shm_ring_header;
+
+        static_assert(codec_type::is_fixed_size,
+                      "shm_signal arguments must have a fixed size encoding, see codec_traits");
+
+        struct receiver_state {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool scheduled = false;
+            bool stopped = false;       // stopped from the queue, pending drain tasks are skipped
+        };
+
+    public:
+        ~shm_signal() {
+            stop();
+        }
+
+        shm_signal(const shm_signal&) = delete;
+        shm_signal& operator=(const shm_signal&) = delete;
+
+        /**
+         * Create the segment name with room for capacity pending emissions,
+         * rounded up to a power of two. Returns nullptr on failure.
+         */
+        static std::unique_ptr<shm_signal> create(std::string_view name, std::size_t capacity) {
+            std::size_t cap = 2;
+            while (cap < capacity) {
+                cap <<= 1;
+            }
+            auto shm = core::SharedMemory::Create(name, header_size() + cap * cell_size());
+            if (!shm) {
+                return nullptr;
+            }
+
+            auto *header = new (shm->Data()) header_type;
+            header->signature = codec_type::signature();
+            header->capacity = cap;
+            header->cell_size = cell_size();
+            for (std::size_t i = 0; i < cap; ++i) {
+                new (cell(shm->Data(), i)) std::atomic<std::uint64_t>(i);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            header->magic = header_type::magic_value;
+            return std::unique_ptr<shm_signal>(new shm_signal(std::move(shm)));
+        }
+
+        /**
+         * Open a segment created by another process. Returns nullptr if it does
+         * not exist or was created for other argument types.
+         */
+        static std::unique_ptr<shm_signal> open(std::string_view name) {
+            auto shm = core::SharedMemory::Open(name);
+            if (!shm || shm->Size() < header_size()) {
+                return nullptr;
+            }
+            auto *header = static_cast<header_type*>(shm->Data());
+            if (header->magic != header_type::magic_value ||
+                header->signature != codec_type::signature() ||
+                header->cell_size != cell_size() ||
+                shm->Size() < header_size() + header->capacity * cell_size()) {
+                return nullptr;
+            }
+            return std::unique_ptr<shm_signal>(new shm_signal(std::move(shm)));
+        }
+
+        /**
+         * Emit into the ring, returns false if the ring is full
+         */
+        bool try_emit(const std::decay_t<T>& ...a) {
+            const std::uint64_t mask = m_header->capacity - 1;
+            auto pos = m_header->enqueue_pos.load(std::memory_order_relaxed);
+            for (;;) {
+                auto *seq = cell(m_shm->Data(), pos & mask);
+                const auto s = seq->load(std::memory_order_acquire);
+                const auto diff = static_cast<std::int64_t>(s - pos);
+                if (diff == 0) {
+                    if (m_header->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        codec_type::encode(payload(seq), a...);
+                        seq->store(pos + 1, std::memory_order_release);
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_header->enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            // pairs with the check of the receiver before it goes to sleep
+            m_header->wake_seq.fetch_add(1);
+            if (m_header->waiting.load()) {
+                core::WakeAddress(&m_header->wake_seq);
+            }
+            return true;
+        }
+
+        /**
+         * Emit into the ring, waiting for room if it is full
+         */
+        void operator()(const std::decay_t<T>& ...a) {
+            while (!try_emit(a...)) {
+                std::this_thread::yield();
+            }
+        }
+
+        /**
+         * Start re-emitting the content of the ring on the local signal, from
+         * queue. Only one process at a time may receive from a segment.
+         *          * @return false if another receiver is attached to the segment
+         */
+        bool start(core::TaskQueue *queue) {
+            assert(queue);
+            std::uint32_t expected = 0;
+            if (m_thread.joinable() || !m_header->receiver.compare_exchange_strong(expected, 1)) {
+                return false;
+            }
+            m_queue = queue;
+            m_stop = false;
+            m_state = std::make_shared<receiver_state>();
+            m_thread = std::thread([this]() { receive(); });
+            return true;
+        }
+
+        /**
+         * Stop receiving, pending emissions stay in the ring. From another thread
+         * than the queue, waits for a drain task in progress. From the queue, a
+         * pending drain task is skipped instead. From a slot of the local signal,
+         * the slot must return before the shm_signal is destroyed.
+         */
+        void stop() {
+            if (!m_thread.joinable()) {
+                return;
+            }
+            m_stop = true;
+            m_header->wake_seq.fetch_add(1);
+            core::WakeAddress(&m_header->wake_seq);
+            {
+                std::lock_guard<std::mutex> _{m_state->mutex};
+                // the queue cannot run the drain task the receiving thread waits for
+                m_state->stopped = m_queue->IsCurrent();
+                m_state->cv.notify_all();
+            }
+            m_thread.join();
+            m_header->receiver = 0;
+        }
+
+        /**
+         * The local signal the received emissions are re-emitted on
+         */
+        signal<T...>& local() noexcept {
+            return m_local;
+        }
+
+        /**
+         * Connect a slot to the local signal, see signal_base::connect
+         */
+        template <typename... CallArgs>
+        connection connect(CallArgs&& ...args) {
+            return m_local.connect(std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Number of emissions waiting in the ring
+         */
+        std::size_t pending() const noexcept {
+            return static_cast<std::size_t>(m_header->enqueue_pos.load() - m_header->dequeue_pos.load());
+        }
+
+    private:
+        explicit shm_signal(std::unique_ptr<core::SharedMemory> shm)
+        : m_shm(std::move(shm))
+        , m_header(static_cast<header_type*>(m_shm->Data()))
+        {}
+
+        static constexpr std::size_t header_size() {
+            return (sizeof(header_type) + header_type::cache_line - 1) / header_type::cache_line * header_type::cache_line;
+        }
+
+        static constexpr std::size_t cell_size() {
+            const std::size_t size = header_type::payload_offset + codec_type::fixed_size();
+            return (size + header_type::cache_line - 1) / header_type::cache_line * header_type::cache_line;
+        }
+
+        static std::atomic<std::uint64_t>* cell(void *base, std::size_t index) {
+            auto *p = static_cast<unsigned char*>(base) + header_size() + index * cell_size();
+            return std::launder(reinterpret_cast<std::atomic<std::uint64_t>*>(p));
+        }
+
+        static unsigned char* payload(std::atomic<std::uint64_t> *cell) {
+            return reinterpret_cast<unsigned char*>(cell) + header_type::payload_offset;
+        }
+
+        bool empty() const {
+            const std::uint64_t mask = m_header->capacity - 1;
+            const auto pos = m_header->dequeue_pos.load(std::memory_order_relaxed);
+            return cell(m_shm->Data(), pos & mask)->load() != pos + 1;
+        }
+
+        // drain the ring on the receiving queue, in place
+        void drain() {
+            const std::uint64_t mask = m_header->capacity - 1;
+            auto pos = m_header->dequeue_pos.load(std::memory_order_relaxed);
+            while (!m_stop) {
+                auto *seq = cell(m_shm->Data(), pos & mask);
+                if (seq->load(std::memory_order_acquire) != pos + 1) {
+                    break;
+                }
+                codec_type::decode(payload(seq), codec_type::fixed_size(), m_local);
+                seq->store(pos + mask + 1, std::memory_order_release);
+                m_header->dequeue_pos.store(++pos, std::memory_order_release);
+            }
+        }
+
+        // receiving thread, sleeps on the futex of the segment and posts a drain
+        // task to the queue when emissions are available
+        void receive() {
+            auto state = m_state;
+            while (!m_stop) {
+                const auto seq = m_header->wake_seq.load();
+                if (empty()) {
+                    m_header->waiting.store(1);
+                    if (empty() && !m_stop) {
+                        core::WaitOnAddress(&m_header->wake_seq, seq, std::chrono::milliseconds(100));
+                    }
+                    m_header->waiting.store(0);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->scheduled = true;
+                m_queue->PostTask([this, state]() {
+                    // stop() waits for the drain task before the signal goes away,
+                    // unless it ran on this queue
+                    if (std::lock_guard<std::mutex> _{state->mutex}; state->stopped) {
+                        return;
+                    }
+                    drain();
+                    std::lock_guard<std::mutex> _{state->mutex};
+                    state->scheduled = false;
+                    state->cv.notify_all();
+                });
+                state->cv.wait(lock, [&state]() { return !state->scheduled || state->stopped; });
+            }
+        }
+
+    private:
+        std::unique_ptr<core::SharedMemory> m_shm;
+        header_type *m_header;
+        signal<T...> m_local;
+        core::TaskQueue *m_queue = nullptr;
+        std::shared_ptr<receiver_state> m_state;
+        std::atomic<bool> m_stop{false};
+        std::thread m_thread;
+    };
+
+} // namespace sigslot
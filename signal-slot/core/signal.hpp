@@ -1,11 +1,24 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <iterator>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <thread>
 #include <vector>
@@ -15,12 +28,19 @@
 #include <typeinfo>
 #endif
 
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
 #include <iostream>
 #include <assert.h>
 
-namespace core {
-    class TaskQueue;
-}
+#include "task_queue.hpp"
+#include "task_queue_base.hpp"
+#include "task_queue_group.hpp"
+#include "codec.hpp"
+#include "mapped_file.hpp"
+#include "counting_allocator.hpp"
 
 namespace sigslot {
     //class i_executor;
@@ -28,6 +48,9 @@ namespace sigslot {
     template <typename, typename...>
     class signal_base;
 
+    template <typename>
+    struct observer_base;
+
     namespace detail {
 
         // Used to detect an object of observer type
@@ -110,6 +133,13 @@ namespace sigslot {
             struct is_signal<signal_base<L, T...>>
             : std::true_type {};
 
+            template <typename T, typename = void>
+            struct is_equality_comparable : std::false_type {};
+
+            template <typename T>
+            struct is_equality_comparable<T, void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+            : std::true_type {};
+
         } // namespace detail
 
         static constexpr bool with_rtti =
@@ -149,6 +179,10 @@ namespace sigslot {
         template <typename S>
         constexpr bool is_signal_v = detail::is_signal<S>::value;
 
+        /// determine if all the decayed types T... can be compared with operator==
+        template <typename... T>
+        constexpr bool is_equality_comparable_v = std::conjunction<detail::is_equality_comparable<std::decay_t<T>>...>::value;
+
     } // namespace trait
 
     enum connection_type {
@@ -157,7 +191,73 @@ namespace sigslot {
         queued_connection = 2,
         blocking_queued_connection = 3,
         unique_connection = 0x80,
-        singleshot_connection = 0x100
+        singleshot_connection = 0x100,
+        changed_only = 0x200    // refused for arguments without operator==, see connect_distinct()
+    };
+
+    /**
+     * A rate_limit describes how often a connection may deliver emissions, see
+     * signal_base::connect_limited().
+     *      * - throttle: at most one delivery per interval. With the leading edge, the
+     *   first emission of an interval is delivered right away and the next ones
+     *   are dropped. With the trailing edge, the last emission of the interval
+     *   is delivered once it elapsed.
+     * - debounce: the last emission is delivered once no other emission happened
+     *   during the interval.
+     * - sample: every Nth emission is delivered.
+     *      * Deferred deliveries (trailing throttle and debounce) are posted with
+     * TaskQueue::PostDelayedTask() and thus need the connection to have a queue,
+     * the slot is called on that queue. Intervals are measured with the clock
+     * of the queue, see TaskQueueBase::GetClock().
+     */
+    struct rate_limit {
+        enum class kind { throttle, debounce, sample };
+        enum class edge_type { leading, trailing };
+
+        static rate_limit throttle(std::chrono::milliseconds interval, edge_type edge = edge_type::leading) {
+            return {kind::throttle, edge, interval, 0};
+        }
+
+        static rate_limit debounce(std::chrono::milliseconds quiet) {
+            return {kind::debounce, edge_type::trailing, quiet, 0};
+        }
+
+        static rate_limit sample(std::uint32_t every) {
+            return {kind::sample, edge_type::leading, std::chrono::milliseconds{0}, every};
+        }
+
+        kind mode;
+        edge_type edge;
+        std::chrono::milliseconds interval;
+        std::uint32_t every;
+    };
+
+    /**
+     * How a balanced connection picks the queue of each delivery among its
+     * queues, see signal_base::connect_balanced().
+     *      * - round_robin: the queues are used in turn.
+     * - two_choices: two queues are drawn at random and the one with the fewest
+     *   pending tasks is used, which avoids herding on a single idle queue.
+     */
+    enum class balance_policy { round_robin, two_choices };
+
+    /**
+     * Settings of a spilling connection, see signal_base::connect_spilling().
+     *      * Once the slot queue holds max_pending tasks, further deliveries are
+     * encoded in memory mapped files named path.0, path.1, ... of chunk_size
+     * bytes each, removed once read back. The path must be unique to the
+     * connection.
+     *
+     * A delivery that cannot be written to a spill file, the disk being full
+     * for instance, is posted normally if nothing is spilled. Otherwise it is
+     * dropped, since posting it would overtake the spilled ones, and counted in
+     * dropped when set, which must then outlive the connection.
+     */
+    struct spill_options {
+        std::string path;
+        std::size_t max_pending = 10000;
+        std::size_t chunk_size = 1024 * 1024;
+        std::atomic<std::uint64_t> *dropped = nullptr;
     };
 
     /**
@@ -165,6 +265,146 @@ namespace sigslot {
      */
     using group_id = std::int32_t;
 
+    /**
+     * A connection of a signal, as reported by connection_graph::snapshot()
+     */
+    struct graph_edge {
+        std::uint32_t type = 0;             // connection_type, without the flags
+        group_id group = 0;
+        std::vector<std::string> queues;    // target queues, several for keyed and balanced connections
+        const void *object = nullptr;       // receiver of member function slots
+        const void *target = nullptr;       // chained signal
+        std::uint64_t deliveries = 0;       // slot calls since the slot was connected
+        bool blocked = false;
+    };
+
+    /**
+     * A signal and its connections, see connection_graph::snapshot()
+     */
+    struct graph_node {
+        const void *signal = nullptr;
+        std::string name;
+        std::vector<graph_edge> edges;
+    };
+
+    /**
+     * Time spent in a slot, as reported by slot_profiler::snapshot()
+     */
+    struct slot_cpu_stats {
+        const void *signal = nullptr;
+        std::string callable;               // type of the callable, empty without RTTI
+        std::uint32_t type = 0;             // connection_type, without the flags
+        std::string queue;                  // queue the slot ran on, empty for other threads
+        std::uint64_t calls = 0;
+        std::chrono::nanoseconds cpu{0};    // thread CPU time
+        std::chrono::nanoseconds wall{0};
+    };
+
+    namespace detail {
+
+        // readable name of a type from typeid().name(), unchanged where the
+        // compiler offers no demangler
+        inline std::string demangle(const std::string& name) {
+#if defined(__GNUG__)
+            int status = 0;
+            char *readable = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+            if (status == 0 && readable) {
+                std::string result(readable);
+                std::free(readable);
+                return result;
+            }
+            std::free(readable);
+#endif
+            return name;
+        }
+
+        /*
+         * Registry of the signals created while the connection graph is
+         * enabled. Each signal registers a function describing its slots, called
+         * under the registry mutex, so a signal unregistering itself first thing
+         * on destruction is never described half destroyed.
+         */
+        class graph_registry {
+        public:
+            using describe_fn = std::function<void(std::vector<graph_edge>&)>;
+
+            static graph_registry& instance() {
+                static graph_registry registry;
+                return registry;
+            }
+
+            void enable() noexcept {
+                m_enabled.store(true, std::memory_order_release);
+            }
+
+            void disable() noexcept {
+                m_enabled.store(false, std::memory_order_release);
+            }
+
+            bool enabled() const noexcept {
+                return m_enabled.load(std::memory_order_acquire);
+            }
+
+            void add(const void *signal, describe_fn describe) {
+                std::lock_guard<std::mutex> _{m_mutex};
+                m_signals[signal] = entry{m_next++, {}, std::move(describe)};
+            }
+
+            void remove(const void *signal) {
+                std::lock_guard<std::mutex> _{m_mutex};
+                m_signals.erase(signal);
+            }
+
+            bool set_name(const void *signal, std::string_view name) {
+                std::lock_guard<std::mutex> _{m_mutex};
+                auto it = m_signals.find(signal);
+                if (it == m_signals.end()) {
+                    return false;
+                }
+                it->second.name = std::string(name);
+                return true;
+            }
+
+            // the signals in creation order
+            std::vector<graph_node> snapshot() const {
+                std::vector<std::pair<std::uint64_t, graph_node>> nodes;
+                {
+                    std::lock_guard<std::mutex> _{m_mutex};
+                    nodes.reserve(m_signals.size());
+                    for (auto& [signal, e] : m_signals) {
+                        graph_node node;
+                        node.signal = signal;
+                        node.name = e.name;
+                        e.describe(node.edges);
+                        nodes.emplace_back(e.order, std::move(node));
+                    }
+                }
+                std::sort(nodes.begin(), nodes.end(), [](const auto& a, const auto& b) {
+                    return a.first < b.first;
+                });
+                std::vector<graph_node> result;
+                result.reserve(nodes.size());
+                for (auto& n : nodes) {
+                    result.push_back(std::move(n.second));
+                }
+                return result;
+            }
+
+        private:
+            struct entry {
+                std::uint64_t order;
+                std::string name;
+                describe_fn describe;
+            };
+
+            std::atomic<bool> m_enabled{false};
+            mutable std::mutex m_mutex;
+            std::unordered_map<const void*, entry> m_signals;
+            std::uint64_t m_next = 0;
+        };
+
+    } // namespace detail
+
     namespace detail {
 
         /**
@@ -420,7 +660,8 @@ namespace sigslot {
 
         /**
          * A simple copy on write container that will be used to improve slot lists
-         * access efficiency in a multithreaded context.
+         * access efficiency in a multithreaded context. Payloads and the copies
+         * made by writers are accounted in memory_stats().
          */
         template <typename T>
         class copy_on_write {
@@ -440,13 +681,13 @@ namespace sigslot {
             using element_type = T;
 
             copy_on_write()
-            : m_data(new payload)
+            : m_data(make_payload())
             {}
 
             template <typename U>
             explicit copy_on_write(U&& x, std::enable_if_t<!std::is_same<std::decay_t<U>,
                                                                          copy_on_write>::value>* = nullptr)
-            : m_data(new payload(std::forward<U>(x)))
+            : m_data(make_payload(std::forward<U>(x)))
             {}
 
             copy_on_write(const copy_on_write& x) noexcept
@@ -463,6 +704,7 @@ namespace sigslot {
 
             ~copy_on_write() {
                 if (m_data && (--m_data->count == 0)) {
+                    memory_registry::instance().cow_payloads.sub(sizeof(payload));
                     delete m_data;
                 }
             }
@@ -482,6 +724,7 @@ namespace sigslot {
 
             element_type& write() {
                 if (!unique()) {
+                    memory_registry::instance().cow_copies.fetch_add(1, std::memory_order_relaxed);
                     *this = copy_on_write(read());
                 }
                 return m_data->value;
@@ -497,6 +740,13 @@ namespace sigslot {
             }
 
         private:
+            template <typename... Args>
+            static payload* make_payload(Args&& ...args) {
+                auto *p = new payload(std::forward<Args>(args)...);
+                memory_registry::instance().cow_payloads.add(sizeof(payload));
+                return p;
+            }
+
             bool unique() const noexcept {
                 return m_data->count == 1;
             }
@@ -534,16 +784,33 @@ namespace sigslot {
  * equivalent that will avoid most instantiations with the following tradeoffs:
  * - Not exception safe,
  * - Allocates a separate control block, and will thus make the code slower.
+ * Either way the objects are accounted per type in memory_stats(), the separate
+ * control block excepted.
  */
 #ifdef SIGSLOT_REDUCE_COMPILE_TIME
+        template <typename B>
+        struct counted_delete {
+            memory_counter *counter;
+            std::size_t size;
+
+            void operator()(B *p) const noexcept {
+                counter->sub(size);
+                delete p;
+            }
+        };
+
         template <typename B, typename D, typename ...Arg>
         inline std::shared_ptr<B> make_shared(Arg&& ... arg) {
-            return std::shared_ptr<B>(static_cast<B*>(new D(std::forward<Arg>(arg)...)));
+            auto &counter = slot_memory<D>::counter();
+            counter.add(sizeof(D));
+            return std::shared_ptr<B>(static_cast<B*>(new D(std::forward<Arg>(arg)...)),
+                                      counted_delete<B>{&counter, sizeof(D)});
         }
 #else
         template <typename B, typename D, typename ...Arg>
         inline std::shared_ptr<B> make_shared(Arg&& ... arg) {
-            return std::static_pointer_cast<B>(std::make_shared<D>(std::forward<Arg>(arg)...));
+            return std::static_pointer_cast<B>(std::allocate_shared<D>(counting_allocator<D, slot_memory<D>>{},
+                                                                       std::forward<Arg>(arg)...));
         }
 #endif
 
@@ -559,6 +826,35 @@ namespace sigslot {
             SigT *m_sig{};
         };
 
+        template <typename>
+        struct is_signal_wrapper : std::false_type {};
+
+        template <typename SigT>
+        struct is_signal_wrapper<signal_wrapper<SigT>> : std::true_type {};
+
+
+        class slot_state;
+        class observer_links;
+
+        /* Node of the intrusive connection list of an observer. It is allocated
+         * when the slot is handed to an observer and owned by the slot, which
+         * unlinks itself on disconnection or destruction.
+         */
+        struct observer_hook {
+            observer_hook *prev = nullptr;   // null when not linked
+            observer_hook *next = nullptr;
+            std::weak_ptr<slot_state> state;
+            std::weak_ptr<observer_links> list;
+        };
+
+        /* The connection list of an observer, shared with its slots so that slots
+         * outliving the observer never touch a dangling list.
+         */
+        class observer_links {
+        public:
+            virtual ~observer_links() = default;
+            virtual void unlink(observer_hook *hook) noexcept = 0;
+        };
 
         /* slot_state holds slot type independent state, to be used to interact with
          * slots indirectly through connection and scoped_connection objects.
@@ -572,7 +868,10 @@ namespace sigslot {
             , m_blocked(false)
             {}
 
-            virtual ~slot_state() = default;
+            virtual ~slot_state() {
+                unlink_observer();
+                delete m_hook.load(std::memory_order_acquire);
+            }
 
             virtual bool connected() const noexcept { return m_connected; }
 
@@ -580,6 +879,7 @@ namespace sigslot {
                 bool ret = m_connected.exchange(false);
                 if (ret) {
                     do_disconnect();
+                    unlink_observer();
                 }
                 return ret;
             }
@@ -607,10 +907,22 @@ namespace sigslot {
             template <typename, typename...>
             friend class ::sigslot::signal_base;
 
+            template <typename>
+            friend struct ::sigslot::observer_base;
+
+            void unlink_observer() noexcept {
+                if (auto *hook = m_hook.load(std::memory_order_acquire)) {
+                    if (auto list = hook->list.lock()) {
+                        list->unlink(hook);
+                    }
+                }
+            }
+
             std::size_t m_index;     // index into the array of slot pointers inside the signal
             const group_id m_group;  // slot group this slot belongs to
             std::atomic<bool> m_connected;
             std::atomic<bool> m_blocked;
+            std::atomic<observer_hook*> m_hook{nullptr};  // set once if tracked by an observer
         };
 
     } // namespace detail
@@ -710,6 +1022,7 @@ namespace sigslot {
 
     protected:
         template <typename, typename...> friend class signal_base;
+        template <typename> friend struct observer_base;
         explicit connection(std::weak_ptr<detail::slot_state> s) noexcept
         : m_state{std::move(s)}
         {}
@@ -761,7 +1074,14 @@ namespace sigslot {
      */
     template <typename Lockable>
     struct observer_base : private detail::observer_type {
-        virtual ~observer_base() = default;
+        observer_base() : m_links(std::allocate_shared<links>(counting_allocator<links, detail::observer_memory>{})) {}
+
+        virtual ~observer_base() {
+            disconnect_all();
+        }
+
+        observer_base(const observer_base&) = delete;
+        observer_base& operator=(const observer_base&) = delete;
 
     protected:
         /**
@@ -771,21 +1091,106 @@ namespace sigslot {
          * destructor. This will ensure proper disconnection prior to the destruction.
          */
         void disconnect_all() {
-            std::unique_lock<Lockable> _{m_mutex};
-            m_connections.clear();
+            std::vector<std::weak_ptr<detail::slot_state>> states;
+            {
+                std::unique_lock<Lockable> _{m_links->mutex};
+                states.reserve(m_links->count);
+                m_links->detach_all([&](detail::observer_hook *hook) {
+                    states.push_back(hook->state);
+                });
+            }
+
+            // disconnect outside of the lock, slots unlink themselves on disconnection
+            for (auto &state : states) {
+                if (auto s = state.lock()) {
+                    s->disconnect();
+                }
+            }
+        }
+
+        /**
+         * Number of live connections tracked by this object. Connections that got
+         * disconnected or destroyed elsewhere are not accounted for.
+         */
+        std::size_t connection_count() const {
+            std::unique_lock<Lockable> _{m_links->mutex};
+            return m_links->count;
+        }
+
+        /**
+         * The lock guarding the connection list, for instance to read the
+         * counters of an instrumented_lock
+         */
+        Lockable& lockable() const noexcept {
+            return m_links->mutex;
         }
 
     private:
         template <typename, typename ...>
         friend class signal_base;
 
+        // circular doubly linked list of hooks owned by the slots, with a sentinel head
+        struct links final : detail::observer_links {
+            links() noexcept {
+                head.prev = head.next = &head;
+            }
+
+            void link(detail::observer_hook *hook) noexcept {
+                std::unique_lock<Lockable> _{mutex};
+                hook->prev = &head;
+                hook->next = head.next;
+                head.next->prev = hook;
+                head.next = hook;
+                ++count;
+            }
+
+            void unlink(detail::observer_hook *hook) noexcept override {
+                std::unique_lock<Lockable> _{mutex};
+                if (hook->prev) {
+                    hook->prev->next = hook->next;
+                    hook->next->prev = hook->prev;
+                    hook->prev = hook->next = nullptr;
+                    --count;
+                }
+            }
+
+            // must be called with the mutex held
+            template <typename Func>
+            void detach_all(Func &&f) {
+                for (auto *hook = head.next; hook != &head;) {
+                    auto *next = hook->next;
+                    f(hook);
+                    hook->prev = hook->next = nullptr;
+                    hook = next;
+                }
+                head.prev = head.next = &head;
+                count = 0;
+            }
+
+            mutable Lockable mutex;
+            detail::observer_hook head;
+            std::size_t count = 0;
+        };
+
         void add_connection(connection conn) {
-            std::unique_lock<Lockable> _{m_mutex};
-            m_connections.emplace_back(std::move(conn));
+            auto state = conn.m_state.lock();
+            if (!state) {
+                return;
+            }
+
+            auto *hook = new detail::observer_hook;
+            hook->state = state;
+            hook->list = m_links;
+            m_links->link(hook);
+            state->m_hook.store(hook, std::memory_order_release);
+
+            // the slot may have been disconnected before the hook got published
+            if (!state->connected()) {
+                m_links->unlink(hook);
+            }
         }
 
-        Lockable m_mutex;
-        std::vector<scoped_connection> m_connections;
+        std::shared_ptr<links> m_links;
     };
 
     /**
@@ -799,6 +1204,143 @@ namespace sigslot {
     using observer = observer_base<std::mutex>;
 
 
+    /**
+     * How an emission_batch coalesces the emissions of a signal
+     */
+    enum class batch_mode {
+        last_value,  // only the last emission of each signal is delivered
+        all_values   // every emission is delivered, in order
+    };
+
+    namespace detail {
+
+        // type erased record of the emissions of one signal inside a batch
+        struct batched_emission {
+            explicit batched_emission(const void *sig) noexcept
+            : signal(sig)
+            {}
+
+            virtual ~batched_emission() = default;
+            virtual void flush() = 0;
+
+            const void *signal;
+        };
+
+        template <typename Sig, typename... T>
+        class batched_emission_of final : public batched_emission {
+        public:
+            batched_emission_of(const Sig& sig, batch_mode mode)
+            : batched_emission(&sig)
+            , m_mode(mode)
+            {}
+
+            template <typename... U>
+            void record(U&& ...u) {
+                if (m_mode == batch_mode::last_value && !m_values.empty()) {
+                    m_values.front() = std::forward_as_tuple(std::forward<U>(u)...);
+                } else {
+                    m_values.emplace_back(std::forward<U>(u)...);
+                }
+            }
+
+            void flush() override {
+                const auto& sig = *static_cast<const Sig*>(signal);
+                for (auto& v : m_values) {
+                    std::apply(sig, v);
+                }
+                m_values.clear();
+            }
+
+        private:
+            const batch_mode m_mode;
+            std::vector<std::tuple<std::decay_t<T>...>> m_values;
+        };
+
+    } // namespace detail
+
+    /**
+     * emission_batch is a RAII scope coalescing the emissions of any number of
+     * signals made by the current thread.
+     *      * While a batch is alive, emissions are recorded instead of being delivered,
+     * only keeping the last value of each signal or all of them depending on
+     * the batch mode. They are flushed when the batch is destroyed, signal after
+     * signal in the order of their first emission, so that downstream queues
+     * receive one delivery per signal instead of one per emission.
+     *      * Batches nest: an inner batch flushes into the enclosing one. Signals
+     * emitted inside a batch must outlive it, or be destroyed on the thread
+     * owning the batch.
+     */
+    class emission_batch {
+    public:
+        explicit emission_batch(batch_mode mode = batch_mode::last_value)
+        : m_mode(mode)
+        , m_outer(std::exchange(current(), this))
+        {}
+
+        ~emission_batch() {
+            current() = m_outer;
+            flush();
+        }
+
+        emission_batch(const emission_batch&) = delete;
+        emission_batch& operator=(const emission_batch&) = delete;
+
+        /**
+         * Delivers the emissions recorded so far
+         */
+        void flush() {
+            auto emissions = std::move(m_emissions);
+            m_emissions.clear();
+            auto *self = std::exchange(current(), m_outer);
+            for (auto& e : emissions) {
+                e->flush();
+            }
+            current() = self;
+        }
+
+    private:
+        template <typename, typename...>
+        friend class signal_base;
+
+        // the innermost batch of the calling thread, if any
+        static emission_batch*& current() noexcept {
+            static thread_local emission_batch *batch = nullptr;
+            return batch;
+        }
+
+        template <typename Sig, typename... T, typename... U>
+        void record(const Sig& sig, U&& ...u) {
+            using record_t = detail::batched_emission_of<Sig, T...>;
+            record_t *r = nullptr;
+            for (auto& e : m_emissions) {
+                if (e->signal == &sig) {
+                    r = static_cast<record_t*>(e.get());
+                    break;
+                }
+            }
+            if (!r) {
+                m_emissions.push_back(std::make_unique<record_t>(sig, m_mode));
+                r = static_cast<record_t*>(m_emissions.back().get());
+            }
+            r->record(std::forward<U>(u)...);
+        }
+
+        // drop the emissions of a signal being destroyed from the batches of this thread
+        static void discard(const void *sig) {
+            for (auto *b = current(); b; b = b->m_outer) {
+                auto& em = b->m_emissions;
+                em.erase(std::remove_if(em.begin(), em.end(), [sig](const auto& e) {
+                    return e->signal == sig;
+                }), em.end());
+            }
+        }
+
+        const batch_mode m_mode;
+        emission_batch *m_outer;
+        std::vector<std::unique_ptr<detail::batched_emission>> m_emissions;
+    };
+
+
     namespace detail {
 
         // interface for cleanable objects, used to cleanup disconnected slots
@@ -813,76 +1355,926 @@ namespace sigslot {
         template <typename... T>
         using slot_ptr = std::shared_ptr<slot_base<T...>>;
 
-
-        /* A base class for slot objects. This base type only depends on slot argument
-         * types, it will be used as an element in an intrusive singly-linked list of
-         * slots, hence the public next member.
+        /*
+         * An emission_filter is consulted by a slot before each emission, and may
+         * veto it before any work (and in particular any task posting) happens.
          */
         template <typename... Args>
-        class slot_base : public slot_state {
-        public:
-            using base_types = trait::typelist<Args...>;
+        struct emission_filter {
+            virtual ~emission_filter() = default;
 
-            explicit slot_base(cleanable& c, uint32_t type, core::TaskQueue* queue, group_id gid)
-            : slot_state(gid)
-            , m_cleaner(c)
-            , m_queue(queue) {
-                m_singleshot = type & connection_type::singleshot_connection;
-                uint32_t t = type;
-                t &= ~connection_type::unique_connection;
-                t &= ~connection_type::singleshot_connection;
-                m_type = t;
+            // returns false if the emission must be suppressed for this slot
+            virtual bool accept(const std::decay_t<Args>& ...args) = 0;
+        };
+
+        // default key of a changed_only connection: the whole argument tuple
+        struct args_tuple {
+            template <typename... A>
+            auto operator()(const A& ...a) const {
+                return std::make_tuple(a...);
             }
+        };
 
-            ~slot_base() override = default;
+        /*
+         * Filter of changed_only connections. It remembers the key of the last
+         * accepted emission and suppresses the following ones that compare equal.
+         */
+        template <typename KeyFn, typename... Args>
+        class changed_filter final : public emission_filter<Args...> {
+            using key_type = std::decay_t<decltype(std::declval<KeyFn&>()(std::declval<const std::decay_t<Args>&>()...))>;
 
-            // method effectively responsible for calling the "slot" function with
-            // supplied arguments whenever emission happens.
-            virtual void call_slot(Args...) = 0;
+        public:
+            explicit changed_filter(KeyFn key)
+            : m_key(std::move(key))
+            {}
 
-            template <typename... U>
-            void operator()(U&& ...u) {
-                if (slot_state::connected() && !slot_state::blocked()) {
-                    call_slot(std::forward<U>(u)...);
+            bool accept(const std::decay_t<Args>& ...args) override {
+                auto key = m_key(args...);
+                std::lock_guard<spin_mutex> _{m_mutex};
+                if (m_last && *m_last == key) {
+                    return false;
                 }
+                m_last = std::move(key);
+                return true;
             }
 
-            // check if we are storing callable c
-            template <typename C>
-            bool has_callable(const C& c) const {
-                auto p = get_callable();
-                return eq_function_ptr(c, p);
-            }
+        private:
+            KeyFn m_key;
+            spin_mutex m_mutex;
+            std::optional<key_type> m_last;
+        };
 
-            template <typename C>
-            std::enable_if_t<function_traits<C>::must_check_object, bool>
-            has_full_callable(const C& c) const {
-                return has_callable(c) && check_class_type<std::decay_t<C>>();
+        template <typename... Args>
+        std::unique_ptr<emission_filter<Args...>> make_changed_filter() {
+            if constexpr (trait::is_equality_comparable_v<Args...>) {
+                return std::make_unique<changed_filter<args_tuple, Args...>>(args_tuple{});
+            } else {
+                // never connected, see signal_base::accepts()
+                return nullptr;
             }
+        }
 
-            template <typename C>
-            std::enable_if_t<!function_traits<C>::must_check_object, bool>
-            has_full_callable(const C& c) const {
-                return has_callable(c);
-            }
 
-            // check if we are storing object o
-            template <typename O>
-            bool has_object(const O& o) const {
-                return get_object() == get_object_ptr(o);
-            }
+        /*
+         * A queue_router picks the queue of each queued delivery of a slot,
+         * instead of the single queue the slot was connected with.
+         */
+        template <typename... Args>
+        struct queue_router {
+            virtual ~queue_router() = default;
 
-            void set_unique(bool unique) {
-                this->m_unique = unique;
-            }
+            virtual core::TaskQueue* route(const std::decay_t<Args>& ...args) = 0;
 
-            bool is_unique() {
-                return this->m_unique;
-            }
+            // enumerate the queues deliveries may have been posted to
+            virtual void for_each_queue(const std::function<void(core::TaskQueue*)>& f) const = 0;
+        };
 
-        protected:
-            void do_disconnect() final {
-                m_cleaner.clean(this);
+        /*
+         * Router of keyed connections: deliveries of a same key always go to the
+         * same queue of the group, keeping them in order.
+         */
+        template <typename KeyFn, typename... Args>
+        class keyed_router final : public queue_router<Args...> {
+            using key_type = std::decay_t<decltype(std::declval<KeyFn&>()(std::declval<const std::decay_t<Args>&>()...))>;
+
+        public:
+            keyed_router(core::TaskQueueGroup& group, KeyFn key)
+            : m_group(group)
+            , m_key(std::move(key))
+            {}
+
+            core::TaskQueue* route(const std::decay_t<Args>& ...args) override {
+                return m_group.ForKey(std::hash<key_type>{}(m_key(args...)));
+            }
+
+            void for_each_queue(const std::function<void(core::TaskQueue*)>& f) const override {
+                for (std::size_t i = 0; i < m_group.Size(); ++i) {
+                    f(m_group.At(i));
+                }
+            }
+
+        private:
+            core::TaskQueueGroup& m_group;
+            KeyFn m_key;
+        };
+
+
+        /*
+         * Router of balanced connections, each delivery goes to a queue of the
+         * set according to the balance policy, regardless of the arguments.
+         */
+        template <typename... Args>
+        class balanced_router final : public queue_router<Args...> {
+        public:
+            balanced_router(std::vector<core::TaskQueue*> queues, balance_policy policy)
+            : m_queues(std::move(queues))
+            , m_policy(policy)
+            {}
+
+            core::TaskQueue* route(const std::decay_t<Args>& ...) override {
+                const std::size_t n = m_queues.size();
+                if (n < 2) {
+                    return n ? m_queues.front() : nullptr;
+                }
+                if (m_policy == balance_policy::round_robin) {
+                    return m_queues[m_next.fetch_add(1, std::memory_order_relaxed) % n];
+                }
+                auto *a = m_queues[random() % n];
+                auto *b = m_queues[random() % n];
+                return b->PendingTasks() < a->PendingTasks() ? b : a;
+            }
+
+            void for_each_queue(const std::function<void(core::TaskQueue*)>& f) const override {
+                for (auto *queue : m_queues) {
+                    f(queue);
+                }
+            }
+
+        private:
+            // per thread xorshift generator, emitting threads do not share state
+            static std::uint64_t random() noexcept {
+                static thread_local std::uint64_t state =
+                    0x9e3779b97f4a7c15ULL ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                return state;
+            }
+
+            const std::vector<core::TaskQueue*> m_queues;
+            const balance_policy m_policy;
+            std::atomic<std::size_t> m_next{0};
+        };
+
+
+        /*
+         * tracked_pins keeps alive the objects of tracked slots for the duration of
+         * an emission, so that the slots tracking a same object pin it only once.
+         *          * Tracked slots check the liveness of their object with weak_ptr::expired(),
+         * a plain load, and only lock it right before calling the slot function.
+         * While an emission is in progress on the current thread, the locked object
+         * is remembered, and the next slots tracking it reuse the pin instead of
+         * contending on its control block again. The last few objects are kept.
+         */
+        class tracked_pins {
+            static constexpr std::size_t capacity = 8;
+
+            struct pin {
+                const void *type = nullptr;
+                std::shared_ptr<void> object;
+            };
+
+            template <typename T>
+            static const void* type_tag() noexcept {
+                static const char tag = 0;
+                return &tag;
+            }
+
+        public:
+            tracked_pins() noexcept
+            : m_prev(std::exchange(current(), this))
+            {}
+
+            ~tracked_pins() {
+                current() = m_prev;
+            }
+
+            tracked_pins(const tracked_pins&) = delete;
+            tracked_pins& operator=(const tracked_pins&) = delete;
+
+            // the pins of the emission in progress on this thread, if any
+            static tracked_pins*& current() noexcept {
+                static thread_local tracked_pins *pins = nullptr;
+                return pins;
+            }
+
+            // the object of w, kept alive until the end of the emission, or nullptr.
+            // target is the pointer held by w: aliasing weak pointers share their
+            // owner but not their object, a pin is only reused for the same one.
+            template <typename T>
+            T* get(const std::weak_ptr<T>& w, const void *target) {
+                const void *type = type_tag<T>();
+                for (const auto& p : m_pins) {
+                    if (p.type == type && p.object.get() == target &&
+                        !w.owner_before(p.object) && !p.object.owner_before(w)) {
+                        return static_cast<T*>(p.object.get());
+                    }
+                }
+
+                auto sp = w.lock();
+                if (!sp) {
+                    return nullptr;
+                }
+                T *obj = sp.get();
+                auto& p = m_pins[m_next++ % capacity];
+                p.type = type;
+                p.object = std::move(sp);
+                return obj;
+            }
+
+        private:
+            tracked_pins *m_prev;
+            std::size_t m_next = 0;
+            pin m_pins[capacity];
+        };
+
+        template <typename T>
+        struct is_std_weak_ptr : std::false_type {};
+
+        template <typename T>
+        struct is_std_weak_ptr<std::weak_ptr<T>> : std::true_type {};
+
+        /*
+         * Lock a tracked object and call f with a pointer to it, returns false
+         * if the object is gone. target is the object pointer of w, as given by
+         * get_object_ptr() while it was alive.
+         */
+        template <typename WeakPtr, typename F>
+        bool with_tracked(const WeakPtr& w, const void *target, F&& f) {
+            if constexpr (is_std_weak_ptr<WeakPtr>::value) {
+                if (auto *pins = tracked_pins::current()) {
+                    auto *obj = pins->get(w, target);
+                    if (!obj) {
+                        return false;
+                    }
+                    f(obj);
+                    return true;
+                }
+            }
+            auto sp = w.lock();
+            if (!sp) {
+                return false;
+            }
+            f(&*sp);
+            return true;
+        }
+
+        /*
+         * Per-slot state of a rate limited connection (see rate_limit). It decides
+         * for each emission whether it is delivered right away, dropped or kept
+         * for a deferred delivery. The latest arguments are stored in place, so
+         * that emissions do not allocate, and at most one timer is pending at a time.
+         */
+        template <typename... Args>
+        class rate_limiter {
+            using time_point = core::Clock::TimePoint;
+            using args_type = std::tuple<std::decay_t<Args>...>;
+
+        public:
+            enum class action { deliver, drop, schedule };
+
+            // clock is the one of the slot queue, against which timers are due
+            rate_limiter(const rate_limit& limit, const core::Clock& clock)
+            : m_limit(limit)
+            , m_clock(clock)
+            {}
+
+            // deferred deliveries are posted to the slot queue
+            static bool needs_queue(const rate_limit& limit) noexcept {
+                return limit.mode == rate_limit::kind::debounce ||
+                       (limit.mode == rate_limit::kind::throttle &&
+                        limit.edge == rate_limit::edge_type::trailing);
+            }
+
+            bool needs_queue() const noexcept {
+                return needs_queue(m_limit);
+            }
+
+            // called for each emission, schedule means a timer must be armed for delay()
+            action on_emit(const std::decay_t<Args>& ...args) {
+                if (m_limit.mode == rate_limit::kind::sample) {
+                    const auto n = m_count.fetch_add(1, std::memory_order_relaxed) + 1;
+                    return (m_limit.every && n % m_limit.every == 0) ? action::deliver : action::drop;
+                }
+
+                const auto now = m_clock.Now();
+                std::lock_guard<spin_mutex> _{m_mutex};
+
+                if (!needs_queue()) {
+                    if (m_last && now - *m_last < m_limit.interval) {
+                        return action::drop;
+                    }
+                    m_last = now;
+                    return action::deliver;
+                }
+
+                if (m_pending) {
+                    *m_pending = std::tie(args...);
+                } else {
+                    m_pending.emplace(args...);
+                }
+                m_last = now;
+
+                if (m_armed) {
+                    return action::drop;
+                }
+                m_armed = true;
+                return action::schedule;
+            }
+
+            // called when the timer fires, returns the arguments to deliver if any,
+            // otherwise the timer must be armed again for delay()
+            std::optional<args_type> on_timer() {
+                const auto now = m_clock.Now();
+                std::lock_guard<spin_mutex> _{m_mutex};
+
+                if (m_limit.mode == rate_limit::kind::debounce && m_last &&
+                    now - *m_last < m_limit.interval) {
+                    m_delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        m_limit.interval - (now - *m_last));
+                    return std::nullopt;
+                }
+
+                m_armed = false;
+                m_delay = m_limit.interval;
+                auto args = std::move(m_pending);
+                m_pending.reset();
+                return args;
+            }
+
+            std::chrono::milliseconds delay() const noexcept {
+                return m_delay;
+            }
+
+        private:
+            const rate_limit m_limit;
+            const core::Clock& m_clock;
+            std::atomic<std::uint64_t> m_count{0};
+            spin_mutex m_mutex;
+            std::optional<time_point> m_last;
+            std::optional<args_type> m_pending;
+            std::chrono::milliseconds m_delay{m_limit.interval};
+            bool m_armed = false;
+        };
+
+
+        /*
+         * Bounded single producer, single consumer ring of argument tuples, the
+         * channel of spsc connections. The first thread pushing becomes the
+         * producer, the consumer is the slot queue. Pushing and popping are wait
+         * free and do not allocate.
+         */
+        template <typename... Args>
+        class spsc_ring {
+            using args_type = std::tuple<std::decay_t<Args>...>;
+
+            struct cell {
+                alignas(args_type) unsigned char data[sizeof(args_type)];
+
+                args_type* get() noexcept {
+                    return std::launder(reinterpret_cast<args_type*>(data));
+                }
+            };
+
+            static constexpr std::size_t cache_line = 64;
+
+            static std::size_t round_up(std::size_t n) noexcept {
+                std::size_t c = 2;
+                while (c < n) {
+                    c <<= 1;
+                }
+                return c;
+            }
+
+            // identifies the current thread without going through std::thread::id
+            static const void* thread_token() noexcept {
+                static thread_local const char token = 0;
+                return &token;
+            }
+
+        public:
+            explicit spsc_ring(std::size_t capacity)
+            : m_mask(round_up(capacity) - 1)
+            , m_cells(new cell[m_mask + 1])
+            {}
+
+            ~spsc_ring() {
+                const auto tail = m_tail.load(std::memory_order_acquire);
+                for (auto h = m_head.load(std::memory_order_relaxed); h != tail; ++h) {
+                    m_cells[h & m_mask].get()->~args_type();
+                }
+            }
+
+            spsc_ring(const spsc_ring&) = delete;
+            spsc_ring& operator=(const spsc_ring&) = delete;
+
+            // true if the current thread is the producer, the first caller claims it
+            bool is_producer() noexcept {
+                const void *self = thread_token();
+                const void *owner = m_producer.load(std::memory_order_relaxed);
+                if (owner == self) {
+                    return true;
+                }
+                return !owner && m_producer.compare_exchange_strong(owner, self);
+            }
+
+            // producer side, returns false if the ring is full
+            template <typename... U>
+            bool push(U&& ...u) {
+                const auto tail = m_tail.load(std::memory_order_relaxed);
+                if (tail - m_head.load(std::memory_order_acquire) > m_mask) {
+                    return false;
+                }
+                new (m_cells[tail & m_mask].data) args_type(std::forward<U>(u)...);
+                m_tail.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            // consumer side, call f with each of the arguments available
+            template <typename F>
+            void drain(F&& f) {
+                auto head = m_head.load(std::memory_order_relaxed);
+                const auto tail = m_tail.load(std::memory_order_acquire);
+                for (; head != tail; ++head) {
+                    auto *args = m_cells[head & m_mask].get();
+                    args_type local = std::move(*args);
+                    args->~args_type();
+                    m_head.store(head + 1, std::memory_order_release);
+                    std::apply(f, local);
+                }
+            }
+
+            bool empty() const noexcept {
+                return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+            }
+
+            // set while a drain task is pending or running
+            std::atomic<bool> scheduled{false};
+
+            // deliveries of the producer currently going through the regular path
+            std::atomic<std::uint32_t> diverted{0};
+
+        private:
+            const std::size_t m_mask;
+            std::unique_ptr<cell[]> m_cells;
+            std::atomic<const void*> m_producer{nullptr};
+            alignas(cache_line) std::atomic<std::size_t> m_head{0};
+            alignas(cache_line) std::atomic<std::size_t> m_tail{0};
+        };
+
+        /*
+         * Overflow of a spilling connection, as seen by the slot. The arguments
+         * only need a codec when a spilling connection is made, see spill_buffer.
+         */
+        template <typename... Args>
+        class spill_channel {
+        public:
+            virtual ~spill_channel() = default;
+
+            // true while spilled deliveries are waiting, later ones must follow them
+            virtual bool active() const noexcept = 0;
+            virtual std::size_t max_pending() const noexcept = 0;
+
+            // append a delivery, returns false if it could not be stored
+            virtual bool push(const std::decay_t<Args>& ...args) = 0;
+
+            // consumer side, call f with at most max deliveries, in order
+            virtual void drain(std::size_t max, const std::function<void(std::decay_t<Args>& ...)>& f) = 0;
+
+            // a delivery could not be stored while older ones are spilled
+            virtual void drop() noexcept = 0;
+
+            // set while a drain task is pending or running
+            std::atomic<bool> scheduled{false};
+        };
+
+        /*
+         * An ordered log of encoded deliveries in memory mapped chunk files,
+         * appended by the emitting threads and read back by the slot queue. A
+         * chunk is unmapped and removed once read, so that memory stays bounded
+         * by the chunks in use.
+         */
+        template <typename... Args>
+        class spill_buffer final : public spill_channel<Args...> {
+            using codec_type = codec<Args...>;
+            using record_size = std::uint32_t;
+
+            struct chunk {
+                std::unique_ptr<core::MappedFile> file;
+                std::size_t write = 0;
+                std::size_t read = 0;
+            };
+
+        public:
+            explicit spill_buffer(const spill_options& options)
+            : m_options(options)
+            {
+                assert(!m_options.path.empty() && "spilling connections need a path");
+            }
+
+            ~spill_buffer() override {
+                for (auto& c : m_chunks) {
+                    core::MappedFile::Remove(c->file->Path());
+                }
+            }
+
+            bool active() const noexcept override {
+                return m_count.load(std::memory_order_acquire) > 0;
+            }
+
+            std::size_t max_pending() const noexcept override {
+                return m_options.max_pending;
+            }
+
+            void drop() noexcept override {
+                if (m_options.dropped) {
+                    m_options.dropped->fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            bool push(const std::decay_t<Args>& ...args) override {
+                const std::size_t size = codec_type::size(args...);
+                const std::size_t need = (sizeof(record_size) + size + 7) & ~std::size_t{7};
+
+                std::unique_lock<spin_mutex> lock{m_mutex};
+                while (m_chunks.empty() || m_chunks.back()->write + need > m_chunks.back()->file->Size()) {
+                    // the file is created and mapped without holding the spin lock,
+                    // the chunk is appended unless another thread did it meanwhile
+                    const std::size_t index = m_next_chunk++;
+                    lock.unlock();
+                    auto c = std::make_unique<chunk>();
+                    c->file = core::MappedFile::Create(m_options.path + "." + std::to_string(index),
+                                                       std::max(m_options.chunk_size, need));
+                    lock.lock();
+                    if (!c->file) {
+                        return false;
+                    }
+                    if (m_chunks.empty() || m_chunks.back()->write + need > m_chunks.back()->file->Size()) {
+                        m_chunks.push_back(std::move(c));
+                    } else {
+                        core::MappedFile::Remove(c->file->Path());
+                    }
+                }
+                auto& c = *m_chunks.back();
+                auto *p = static_cast<unsigned char*>(c.file->Data()) + c.write;
+                const auto length = static_cast<record_size>(size);
+                std::memcpy(p, &length, sizeof(length));
+                codec_type::encode(p + sizeof(length), args...);
+                c.write += need;
+                m_count.fetch_add(1, std::memory_order_release);
+                return true;
+            }
+
+            void drain(std::size_t max, const std::function<void(std::decay_t<Args>& ...)>& f) override {
+                for (std::size_t n = 0; n < max;) {
+                    const unsigned char *p;
+                    record_size length;
+                    {
+                        std::lock_guard<spin_mutex> _{m_mutex};
+                        if (m_chunks.empty()) {
+                            return;
+                        }
+                        auto& c = *m_chunks.front();
+                        if (c.read == c.write) {
+                            if (m_chunks.size() == 1) {
+                                // everything was read, the chunk is reused from its start
+                                c.read = c.write = 0;
+                                return;
+                            }
+                            core::MappedFile::Remove(c.file->Path());
+                            m_chunks.pop_front();
+                            continue;
+                        }
+                        // the record is complete and stays mapped until read
+                        p = static_cast<const unsigned char*>(c.file->Data()) + c.read;
+                        std::memcpy(&length, p, sizeof(length));
+                        c.read += (sizeof(length) + length + 7) & ~std::size_t{7};
+                    }
+                    codec_type::decode_views(p + sizeof(length), length, [&f](const auto& ...views) {
+                        std::tuple<std::decay_t<Args>...> args(codec_traits<std::decay_t<Args>>::load(views)...);
+                        std::apply(f, args);
+                    });
+                    m_count.fetch_sub(1, std::memory_order_release);
+                    ++n;
+                }
+            }
+
+        private:
+            const spill_options m_options;
+            spin_mutex m_mutex;
+            std::deque<std::unique_ptr<chunk>> m_chunks;
+            std::size_t m_next_chunk = 0;
+            std::atomic<std::size_t> m_count{0};
+        };
+
+
+        /*
+         * Time accounting of the slots created while the slot profiler is
+         * enabled. Each thread adds to its own table, guarded by a spin mutex
+         * only contended while the tables are merged, and a table is folded in
+         * the retired records when its thread exits. The registry is never
+         * destroyed: worker threads may exit after the exit handlers ran.
+         */
+        class cpu_profile_registry {
+            struct key {
+                std::uint64_t slot;
+                const void *queue;
+
+                bool operator==(const key& o) const noexcept {
+                    return slot == o.slot && queue == o.queue;
+                }
+            };
+
+            struct key_hash {
+                std::size_t operator()(const key& k) const noexcept {
+                    return std::hash<std::uint64_t>{}(k.slot) ^ (std::hash<const void*>{}(k.queue) << 1);
+                }
+            };
+
+            using records_type = std::unordered_map<key, slot_cpu_stats, key_hash>;
+
+            struct table {
+                table() { instance().attach(this); }
+                ~table() { instance().retire(this); }
+
+                spin_mutex mutex;
+                records_type records;
+            };
+
+        public:
+            static cpu_profile_registry& instance() {
+                static auto *registry = new cpu_profile_registry;
+                return *registry;
+            }
+
+            void enable() noexcept {
+                m_enabled.store(true, std::memory_order_release);
+            }
+
+            void disable() noexcept {
+                m_enabled.store(false, std::memory_order_release);
+            }
+
+            bool enabled() const noexcept {
+                return m_enabled.load(std::memory_order_acquire);
+            }
+
+            std::uint64_t next_id() noexcept {
+                return m_next_id.fetch_add(1, std::memory_order_relaxed) + 1;
+            }
+
+            // add a call of the slot id to the table of the calling thread,
+            // describe is only called the first time the slot runs on a queue
+            template <typename Describe>
+            void record(std::uint64_t id, Describe&& describe, std::chrono::nanoseconds cpu, std::chrono::nanoseconds wall) {
+                auto& t = local_table();
+                const auto *queue = core::TaskQueueBase::Current();
+                std::lock_guard<spin_mutex> _{t.mutex};
+                auto [it, inserted] = t.records.try_emplace(key{id, queue});
+                auto& r = it->second;
+                if (inserted) {
+                    r = describe();
+                    if (queue) {
+                        r.queue = queue->Name();
+                    }
+                }
+                ++r.calls;
+                r.cpu += cpu;
+                r.wall += wall;
+            }
+
+            // the records of all the threads, merged
+            std::vector<slot_cpu_stats> merge() const {
+                std::lock_guard<std::mutex> _{m_mutex};
+                records_type merged = m_retired;
+                for (auto *t : m_tables) {
+                    std::lock_guard<spin_mutex> lock{t->mutex};
+                    add(merged, t->records);
+                }
+                std::vector<slot_cpu_stats> result;
+                result.reserve(merged.size());
+                for (auto& r : merged) {
+                    result.push_back(std::move(r.second));
+                }
+                return result;
+            }
+
+            void reset() {
+                std::lock_guard<std::mutex> _{m_mutex};
+                m_retired.clear();
+                for (auto *t : m_tables) {
+                    std::lock_guard<spin_mutex> lock{t->mutex};
+                    t->records.clear();
+                }
+            }
+
+        private:
+            static table& local_table() {
+                thread_local table t;
+                return t;
+            }
+
+            static void add(records_type& into, const records_type& from) {
+                for (auto& [k, r] : from) {
+                    auto [it, inserted] = into.try_emplace(k, r);
+                    if (!inserted) {
+                        it->second.calls += r.calls;
+                        it->second.cpu += r.cpu;
+                        it->second.wall += r.wall;
+                    }
+                }
+            }
+
+            void attach(table *t) {
+                std::lock_guard<std::mutex> _{m_mutex};
+                m_tables.push_back(t);
+            }
+
+            void retire(table *t) {
+                std::lock_guard<std::mutex> _{m_mutex};
+                {
+                    std::lock_guard<spin_mutex> lock{t->mutex};
+                    add(m_retired, t->records);
+                }
+                m_tables.erase(std::remove(m_tables.begin(), m_tables.end(), t), m_tables.end());
+            }
+
+        private:
+            std::atomic<bool> m_enabled{false};
+            std::atomic<std::uint64_t> m_next_id{0};
+            mutable std::mutex m_mutex;
+            std::vector<table*> m_tables;
+            records_type m_retired;
+        };
+
+        /* A base class for slot objects. This base type only depends on slot argument
+         * types. It implements emission dispatching according to the connection
+         * type, derived classes only have to implement the call of the slot function.
+         */
+        template <typename... Args>
+        class slot_base : public slot_state, public std::enable_shared_from_this<slot_base<Args...>> {
+        public:
+            using base_types = trait::typelist<Args...>;
+
+            explicit slot_base(cleanable& c, uint32_t type, core::TaskQueue* queue, group_id gid)
+            : slot_state(gid)
+            , m_cleaner(c)
+            , m_queue(queue) {
+                m_singleshot = type & connection_type::singleshot_connection;
+                if (type & connection_type::changed_only) {
+                    m_filter = make_changed_filter<Args...>();
+                }
+                uint32_t t = type;
+                t &= ~connection_type::unique_connection;
+                t &= ~connection_type::singleshot_connection;
+                t &= ~connection_type::changed_only;
+                m_type = t;
+            }
+
+            ~slot_base() override = default;
+
+            template <typename... U>
+            void operator()(U&& ...u) {
+                if (slot_state::connected() && !slot_state::blocked()) {
+                    if (m_filter && !m_filter->accept(u...)) {
+                        return;
+                    }
+                    if (m_limiter) {
+                        limit(std::forward<U>(u)...);
+                        return;
+                    }
+                    dispatch(std::forward<U>(u)...);
+                }
+            }
+
+            // must be called before the slot is added to a signal
+            void set_filter(std::unique_ptr<emission_filter<Args...>> filter) {
+                m_filter = std::move(filter);
+            }
+
+            // must be called before the slot is added to a signal
+            void set_router(std::unique_ptr<queue_router<Args...>> router) {
+                m_router = std::move(router);
+            }
+
+            // must be called before the slot is added to a signal
+            void set_channel(std::unique_ptr<spsc_ring<Args...>> channel) {
+                assert(m_queue && !m_router);
+                m_channel = std::move(channel);
+            }
+
+            // the clock of the slot queue, or the real one without a queue
+            core::Clock& clock() const {
+                return m_queue ? m_queue->GetClock() : core::Clock::Real();
+            }
+
+            // must be called before the slot is added to a signal
+            void set_spill(std::unique_ptr<spill_channel<Args...>> spill) {
+                assert(m_queue && !m_router);
+                m_spill = std::move(spill);
+            }
+
+            // must be called before the slot is added to a signal
+            void set_limiter(std::unique_ptr<rate_limiter<Args...>> limiter) {
+                assert(!limiter->needs_queue() || m_queue);
+                m_limiter = std::move(limiter);
+            }
+
+            // whether the slot locks its object through tracked_pins
+            virtual bool pins_object() const noexcept {
+                return false;
+            }
+
+            // must be called before the slot is added to a signal
+            void profile_cpu() {
+                m_cpu_id = cpu_profile_registry::instance().next_id();
+            }
+
+            // must be called before the slot is added to a signal
+            void count_deliveries() {
+                m_deliveries = std::make_unique<std::atomic<std::uint64_t>>(0);
+            }
+
+            // describe the connection for the connection graph
+            void describe(graph_edge& edge) const {
+                edge.type = m_type;
+                edge.group = this->group();
+                edge.blocked = this->blocked();
+                edge.object = get_object();
+                edge.target = chained_signal();
+                edge.deliveries = m_deliveries ? m_deliveries->load(std::memory_order_relaxed) : 0;
+                if (m_router) {
+                    m_router->for_each_queue([&edge](core::TaskQueue *queue) {
+                        edge.queues.push_back(queue->Name());
+                    });
+                } else if (m_queue) {
+                    edge.queues.push_back(m_queue->Name());
+                }
+            }
+
+            // check if we are storing callable c
+            template <typename C>
+            bool has_callable(const C& c) const {
+                auto p = get_callable();
+                return eq_function_ptr(c, p);
+            }
+
+            template <typename C>
+            std::enable_if_t<function_traits<C>::must_check_object, bool>
+            has_full_callable(const C& c) const {
+                return has_callable(c) && check_class_type<std::decay_t<C>>();
+            }
+
+            template <typename C>
+            std::enable_if_t<!function_traits<C>::must_check_object, bool>
+            has_full_callable(const C& c) const {
+                return has_callable(c);
+            }
+
+            // check if we are storing object o
+            template <typename O>
+            bool has_object(const O& o) const {
+                return get_object() == get_object_ptr(o);
+            }
+
+            void set_unique(bool unique) {
+                this->m_unique = unique;
+            }
+
+            // tag of the queued deliveries of this slot, see core::QueuedTask::set_tag()
+            const void* delivery_tag() const noexcept {
+                return static_cast<const slot_state*>(this);
+            }
+
+            // call f with each of the queues that may hold pending deliveries of
+            // this slot, if any of them neither ran nor was purged yet
+            template <typename F>
+            void for_pending_queues(F&& f) {
+                if (m_pending.load(std::memory_order_acquire) == 0) {
+                    return;
+                }
+                if (m_router) {
+                    m_router->for_each_queue(f);
+                } else if (m_queue) {
+                    f(m_queue);
+                }
+            }
+
+            // drop the deliveries of this slot still pending in its queues
+            void purge_deliveries() {
+                for_pending_queues([this](core::TaskQueue *queue) {
+                    m_pending.fetch_sub(queue->PurgeTasks(delivery_tag()), std::memory_order_acq_rel);
+                });
+            }
+
+            // account a pending delivery purged from a queue
+            void purged() noexcept {
+                m_pending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+
+            bool is_unique() {
+                return this->m_unique;
+            }
+
+        protected:
+            // method effectively responsible for calling the "slot" function with
+            // supplied arguments, on the calling thread. Returns false if the
+            // slot could not be called because its tracked object is gone.
+            virtual bool call_slot(Args&...) = 0;
+
+            void do_disconnect() final {
+                m_cleaner.clean(this);
+                purge_deliveries();
             }
 
             // retieve a pointer to the object embedded in the slot
@@ -895,6 +2287,11 @@ namespace sigslot {
                 return get_function_ptr(nullptr);
             }
 
+            // retrieve the signal this slot emits, for slots chaining signals
+            virtual obj_ptr chained_signal() const noexcept {
+                return nullptr;
+            }
+
             inline bool can_emit() {
                 if (this->m_singleshot && this->m_emitted) {
                     return false;
@@ -946,62 +2343,34 @@ namespace sigslot {
                 return false;
             }
 #endif
-        protected:
-            std::atomic<uint32_t> m_type = {0};
-            std::atomic_bool m_unique = {false};
-            core::TaskQueue* m_queue = nullptr;
-            std::atomic_bool m_singleshot = {false};
-            std::atomic_bool m_emitted = {false};
 
         private:
-            cleanable& m_cleaner;
-        };
-
-        /*
-         * A slot object holds state information, and a callable to to be called
-         * whenever the function call operator of its slot_base base class is called.
-         */
-        template <typename Func, typename... Args>
-        class slot final : public slot_base<Args...>, public std::enable_shared_from_this<slot<Func, Args...>> {
-        public:
-            using this_type = slot<Func, Args...>;
-            template <typename F, typename Gid>
-            constexpr slot(cleanable& c, F&& f, uint32_t type, core::TaskQueue* queue, Gid gid)
-            : slot_base<Args...>(c, type, queue, gid)
-            , func{std::forward<F>(f)} {}
-
-        protected:
-            void call_slot(Args ...args) override {
+            // route an emission according to the connection type
+            void dispatch(Args ...args) {
+                if (!this->connected()) {
+                    // the tracked object, if any, has expired
+                    slot_state::disconnect();
+                    return;
+                }
                 if (!this->can_emit()) {
                     return;
                 }
                 this->set_emitted();
                 uint32_t type = this->type();
                 if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        func(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
+                    deliver(args...);
                 } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                self->func(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
+                    if (m_channel && post_spsc(args...)) {
+                        return;
+                    }
+                    if (m_spill && post_spill(args...)) {
+                        return;
+                    }
+                    auto *queue = m_router ? m_router->route(args...) : this->m_queue;
+                    assert(queue);
+                    if (queue) {
+                        post(queue, [args...](slot_base& self) mutable {
+                            self.deliver(args...);
                         });
                     } else {
                         std::cerr << "thread is nullptr" << std::endl;
@@ -1010,14 +2379,7 @@ namespace sigslot {
                     auto promise = std::promise<void>();
                     assert(this->m_queue);
                     this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            this->func(args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
+                        deliver(args...);
                         promise.set_value();
                     });
                     promise.get_future().get();
@@ -1026,10 +2388,237 @@ namespace sigslot {
                 }
             }
 
+            // call the slot function on the current thread
+            void deliver(Args& ...args) {
+                if (this->slot_state::connected()) {
+                    if (!(m_cpu_id ? call_profiled(args...) : call_slot(args...))) {
+                        slot_state::disconnect();
+                        return;
+                    }
+                    if (m_deliveries) {
+                        m_deliveries->fetch_add(1, std::memory_order_relaxed);
+                    }
+                    if (this->m_singleshot && this->m_emitted) {
+                        this->slot_state::disconnect();
+                    }
+                } else {
+                    std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
+                }
+            }
+
+            // call the slot function, accounting the time spent to the slot
+            bool call_profiled(Args& ...args) {
+                const auto cpu = core::ThreadCpuTime();
+                const auto wall = std::chrono::steady_clock::now();
+                const bool called = call_slot(args...);
+                const auto wall_time = std::chrono::steady_clock::now() - wall;
+                const auto cpu_time = core::ThreadCpuTime() - cpu;
+                cpu_profile_registry::instance().record(m_cpu_id, [this]() {
+                    slot_cpu_stats stats;
+                    stats.signal = &m_cleaner;
+                    stats.type = m_type;
+#ifdef SIGSLOT_RTTI_ENABLED
+                    stats.callable = get_callable_type().name();
+#endif
+                    return stats;
+                }, cpu_time, std::chrono::duration_cast<std::chrono::nanoseconds>(wall_time));
+                return called;
+            }
+
+            // apply the rate limit of the connection to an emission
+            void limit(Args ...args) {
+                switch (m_limiter->on_emit(args...)) {
+                case rate_limiter<Args...>::action::deliver:
+                    dispatch(args...);
+                    break;
+                case rate_limiter<Args...>::action::schedule:
+                    schedule_deferred(m_limiter->delay());
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // deferred deliveries of rate limited connections run on the slot queue
+            void schedule_deferred(std::chrono::milliseconds delay) {
+                m_queue->PostDelayedTask(make_task([](slot_base& self) {
+                    self.run_deferred();
+                }), delay);
+            }
+
+            // post a delivery task calling f with the slot, if still alive
+            template <typename F>
+            void post(core::TaskQueue *queue, F&& f) {
+                queue->PostTask(make_task(std::forward<F>(f)));
+            }
+
+            // a delivery task, tagged so that it can be purged on disconnection,
+            // and counted as pending until it runs or is purged
+            template <typename F>
+            std::unique_ptr<core::QueuedTask> make_task(F&& f) {
+                auto task = core::ToQueuedTask([wself = this->weak_from_this(), f = std::forward<F>(f)]() mutable {
+                    if (auto self = wself.lock()) {
+                        self->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+                        f(*self);
+                    }
+                });
+                task->set_tag(delivery_tag());
+                m_pending.fetch_add(1, std::memory_order_acq_rel);
+                return task;
+            }
+
+            // queue a delivery through the spsc channel, returns false if the
+            // emitting thread is not its producer
+            bool post_spsc(Args& ...args) {
+                auto& ch = *m_channel;
+                if (!ch.is_producer()) {
+                    return false;
+                }
+
+                if (ch.diverted.load(std::memory_order_acquire) == 0 && ch.push(args...)) {
+                    if (!ch.scheduled.exchange(true)) {
+                        post(m_queue, [](slot_base& self) {
+                            self.drain_spsc();
+                        });
+                    }
+                    return true;
+                }
+
+                // the ring is full: use the regular path, and keep using it until
+                // this delivery ran, so that it does not overtake later ones
+                ch.diverted.fetch_add(1, std::memory_order_relaxed);
+                post(m_queue, [args...](slot_base& self) mutable {
+                    self.deliver(args...);
+                    self.m_channel->diverted.fetch_sub(1, std::memory_order_release);
+                });
+                return true;
+            }
+
+            // deliver the content of the spsc channel, runs on the slot queue
+            void drain_spsc() {
+                auto& ch = *m_channel;
+                do {
+                    ch.drain([this](auto& ...a) {
+                        if (slot_state::connected()) {
+                            deliver(a...);
+                        }
+                    });
+                    ch.scheduled.store(false);
+                } while (!ch.empty() && !ch.scheduled.exchange(true));
+            }
+
+            // spill the delivery if the queue is over budget or older deliveries
+            // are spilled, returns false to use the regular path
+            bool post_spill(Args& ...args) {
+                auto& sp = *m_spill;
+                if (!sp.active() && m_queue->PendingTasks() < sp.max_pending()) {
+                    return false;
+                }
+                if (!sp.push(args...)) {
+                    // older deliveries are still spilled, posting this one would
+                    // overtake them
+                    if (!sp.active()) {
+                        return false;
+                    }
+                    sp.drop();
+                    return true;
+                }
+                if (!sp.scheduled.exchange(true)) {
+                    post_spill_drain();
+                }
+                return true;
+            }
+
+            void post_spill_drain() {
+                post(m_queue, [](slot_base& self) {
+                    self.drain_spill();
+                });
+            }
+
+            // deliver spilled emissions by batches, runs on the slot queue and
+            // yields to the other tasks between batches
+            void drain_spill() {
+                auto& sp = *m_spill;
+                sp.drain(256, [this](std::decay_t<Args>& ...args) {
+                    if (slot_state::connected()) {
+                        deliver(args...);
+                    }
+                });
+                if (sp.active()) {
+                    post_spill_drain();
+                    return;
+                }
+                sp.scheduled.store(false);
+                if (sp.active() && !sp.scheduled.exchange(true)) {
+                    post_spill_drain();
+                }
+            }
+
+            void run_deferred() {
+                auto args = m_limiter->on_timer();
+                if (!args) {
+                    schedule_deferred(m_limiter->delay());
+                    return;
+                }
+                if (!slot_state::connected() || slot_state::blocked() || !this->connected()) {
+                    return;
+                }
+                if (!this->can_emit()) {
+                    return;
+                }
+                this->set_emitted();
+                std::apply([this](auto& ...a) { deliver(a...); }, *args);
+            }
+
+        protected:
+            std::atomic<uint32_t> m_type = {0};
+            std::atomic_bool m_unique = {false};
+            core::TaskQueue* m_queue = nullptr;
+            std::atomic_bool m_singleshot = {false};
+            std::atomic_bool m_emitted = {false};
+            std::unique_ptr<emission_filter<Args...>> m_filter;
+            std::unique_ptr<rate_limiter<Args...>> m_limiter;
+            std::unique_ptr<queue_router<Args...>> m_router;
+            std::unique_ptr<spsc_ring<Args...>> m_channel;
+            std::unique_ptr<spill_channel<Args...>> m_spill;
+            std::unique_ptr<std::atomic<std::uint64_t>> m_deliveries;   // set while the connection graph is enabled
+            std::uint64_t m_cpu_id = 0;                                 // set while the slot profiler is enabled
+            std::atomic<std::size_t> m_pending = {0};  // deliveries posted, neither run nor purged
+
+        private:
+            cleanable& m_cleaner;
+        };
+
+        /*
+         * A slot object holds state information, and a callable to to be called
+         * whenever the function call operator of its slot_base base class is called.
+         */
+        template <typename Func, typename... Args>
+        class slot final : public slot_base<Args...> {
+        public:
+            template <typename F, typename Gid>
+            constexpr slot(cleanable& c, F&& f, uint32_t type, core::TaskQueue* queue, Gid gid)
+            : slot_base<Args...>(c, type, queue, gid)
+            , func{std::forward<F>(f)} {}
+
+        protected:
+            bool call_slot(Args& ...args) override {
+                func(args...);
+                return true;
+            }
+
             func_ptr get_callable() const noexcept override {
                 return get_function_ptr(func);
             }
 
+            obj_ptr chained_signal() const noexcept override {
+                if constexpr (is_signal_wrapper<std::decay_t<Func>>::value) {
+                    return func.m_sig;
+                } else {
+                    return nullptr;
+                }
+            }
+
 #ifdef SIGSLOT_RTTI_ENABLED
             const std::type_info& get_callable_type() const noexcept override {
                 return typeid(func);
@@ -1044,9 +2633,8 @@ namespace sigslot {
          * Variation of slot that prepends a connection object to the callable
          */
         template <typename Func, typename... Args>
-        class slot_extended final : public slot_base<Args...>, public std::enable_shared_from_this<slot_extended<Func, Args...>> {
+        class slot_extended final : public slot_base<Args...> {
         public:
-            using this_type = slot_extended<Func, Args...>;
             template <typename F>
             constexpr slot_extended(cleanable& c, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
             : slot_base<Args...>(c, type, queue, gid)
@@ -1055,59 +2643,9 @@ namespace sigslot {
             connection conn;
 
         protected:
-            void call_slot(Args ...args) override {
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        func(conn, args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                self->func(self->conn, args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            this->func(this->conn, args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
-                }
+            bool call_slot(Args& ...args) override {
+                func(conn, args...);
+                return true;
             }
 
             func_ptr get_callable() const noexcept override {
@@ -1130,69 +2668,18 @@ namespace sigslot {
          * base class is called.
          */
         template <typename Ptr, typename Pmf, typename... Args>
-        class slot_pmf final : public slot_base<Args...>, public std::enable_shared_from_this<slot_pmf<Ptr, Pmf, Args...>> {
-        public:
-            using this_type = slot_pmf<Ptr, Pmf, Args...>;
-            template <typename P, typename F>
-            constexpr slot_pmf(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
-            : slot_base<Args...>(c, type, queue, gid)
-            , ptr{std::forward<P>(p)}
-            , pmf{std::forward<F>(f)} {}
-
-        protected:
-            void call_slot(Args ...args) override {
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        ((*ptr).*pmf)(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                ((*(self->ptr)).*(self->pmf))(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            ((*(this->ptr)).*(this->pmf))(args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
-                }
+        class slot_pmf final : public slot_base<Args...> {
+        public:
+            template <typename P, typename F>
+            constexpr slot_pmf(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
+            : slot_base<Args...>(c, type, queue, gid)
+            , ptr{std::forward<P>(p)}
+            , pmf{std::forward<F>(f)} {}
+
+        protected:
+            bool call_slot(Args& ...args) override {
+                ((*ptr).*pmf)(args...);
+                return true;
             }
 
             func_ptr get_callable() const noexcept override {
@@ -1218,9 +2705,8 @@ namespace sigslot {
          * Variation of slot that prepends a connection object to the callable
          */
         template <typename Ptr, typename Pmf, typename... Args>
-        class slot_pmf_extended final : public slot_base<Args...>, public std::enable_shared_from_this<slot_pmf_extended<Ptr, Pmf, Args...>> {
+        class slot_pmf_extended final : public slot_base<Args...> {
         public:
-            using this_type = slot_pmf_extended<Pmf, Ptr, Args...>;
             template <typename P, typename F>
             constexpr slot_pmf_extended(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* executor, group_id gid)
             : slot_base<Args...>(c, type, executor, gid)
@@ -1230,59 +2716,9 @@ namespace sigslot {
             connection conn;
 
         protected:
-            void call_slot(Args ...args) override {
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        ((*ptr).*pmf)(conn, args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                ((*(self->ptr)).*(self->pmf))(self->conn, args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            ((*(this->ptr)).*(this->pmf))(this->conn, args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
-                }
+            bool call_slot(Args& ...args) override {
+                ((*ptr).*pmf)(conn, args...);
+                return true;
             }
 
             func_ptr get_callable() const noexcept override {
@@ -1309,79 +2745,29 @@ namespace sigslot {
          * through a weak pointer in order to automatically disconnect the slot
          * on said object destruction.
          */
-        template <typename WeakPtr, typename Func, typename... Args>
-        class slot_tracked final : public slot_base<Args...>, public std::enable_shared_from_this<slot_tracked<WeakPtr, Func, Args...>> {
+        template <typename Func, typename WeakPtr, typename... Args>
+        class slot_tracked final : public slot_base<Args...> {
         public:
-            using this_type = slot_tracked<Func, WeakPtr, Args...>;
             template <typename P, typename F>
             constexpr slot_tracked(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
             : slot_base<Args...>(c, type, queue, gid)
             , ptr{std::forward<P>(p)}
+            , target{get_object_ptr(ptr)}
             , func{std::forward<F>(f)} {}
 
             bool connected() const noexcept override {
                 return !ptr.expired() && slot_state::connected();
             }
 
+            bool pins_object() const noexcept override {
+                return is_std_weak_ptr<std::decay_t<WeakPtr>>::value;
+            }
+
         protected:
-            void call_slot(Args ...args) override {
-                auto sp = ptr.lock();
-                if (!sp) {
-                    slot_state::disconnect();
-                    return;
-                }
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        func(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                self->func(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            this->func(args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
-                }
+            bool call_slot(Args& ...args) override {
+                return with_tracked(ptr, target, [&](auto*) {
+                    func(args...);
+                });
             }
 
             func_ptr get_callable() const noexcept override {
@@ -1400,6 +2786,7 @@ namespace sigslot {
 
         private:
             std::decay_t<WeakPtr> ptr;
+            const obj_ptr target;       // object of ptr, told apart from aliases of its owner
             std::decay_t<Func> func;
         };
 
@@ -1408,79 +2795,29 @@ namespace sigslot {
          * the life of a supplied object through a weak pointer in order to automatically
          * disconnect the slot on said object destruction.
          */
-        template <typename WeakPtr, typename Pmf, typename... Args>
-        class slot_pmf_tracked final : public slot_base<Args...>, public std::enable_shared_from_this<slot_pmf_tracked<WeakPtr, Pmf, Args...>> {
+        template <typename Pmf, typename WeakPtr, typename... Args>
+        class slot_pmf_tracked final : public slot_base<Args...> {
         public:
-            using this_type = slot_pmf_tracked<Pmf, WeakPtr, Args...>;
             template <typename P, typename F>
             constexpr slot_pmf_tracked(cleanable& c, P&& p, F&& f, uint32_t type, core::TaskQueue* queue, group_id gid)
             : slot_base<Args...>(c, type, queue, gid)
             , ptr{std::forward<P>(p)}
+            , target{get_object_ptr(ptr)}
             , pmf{std::forward<F>(f)} {}
 
             bool connected() const noexcept override {
                 return !ptr.expired() && slot_state::connected();
             }
 
+            bool pins_object() const noexcept override {
+                return is_std_weak_ptr<std::decay_t<WeakPtr>>::value;
+            }
+
         protected:
-            void call_slot(Args ...args) override {
-                auto sp = ptr.lock();
-                if (!sp) {
-                    slot_state::disconnect();
-                    return;
-                }
-                if (!this->can_emit()) {
-                    return;
-                }
-                this->set_emitted();
-                uint32_t type = this->type();
-                if (type == connection_type::direct_connection) {
-                    if (this->slot_state::connected()) {
-                        ((*sp).*pmf)(args...);
-                        if (this->m_singleshot && this->m_emitted) {
-                            this->slot_state::disconnect();
-                        }
-                    } else {
-                        std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                    }
-                } else if (type == connection_type::queued_connection) {
-                    assert(this->m_queue);
-                    if (this->m_queue) {
-                        this->m_queue->PostTask([wself = std::weak_ptr<this_type>(this_type::shared_from_this()), sp, args...]() mutable {
-                            auto self = wself.lock();
-                            if (!self) {
-                                return;
-                            }
-                            if (self->slot_state::connected()) {
-                                ((*sp).*(self->pmf))(args...);
-                                if (self->m_singleshot && self->m_emitted) {
-                                    self->slot_state::disconnect();
-                                }
-                            } else {
-                                std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                            }
-                        });
-                    } else {
-                        std::cerr << "thread is nullptr" << std::endl;
-                    }
-                } else if (type == connection_type::blocking_queued_connection) {
-                    auto promise = std::promise<void>();
-                    assert(this->m_queue);
-                    this->m_queue->PostTask([this, sp, &args..., &promise]() mutable {
-                        if (this->slot_state::connected()) {
-                            (*sp.*(this->pmf))(this->conn, args...);
-                            if (this->m_singleshot && this->m_emitted) {
-                                this->slot_state::disconnect();
-                            }
-                        } else {
-                            std::cerr << "canceling slot execution due to connection being disconnected" << std::endl;
-                        }
-                        promise.set_value();
-                    });
-                    promise.get_future().get();
-                } else {
-                    std::cerr << "illegal connection type" << std::endl;
-                }
+            bool call_slot(Args& ...args) override {
+                return with_tracked(ptr, target, [&](auto *obj) {
+                    ((*obj).*pmf)(args...);
+                });
             }
 
             func_ptr get_callable() const noexcept override {
@@ -1499,6 +2836,7 @@ namespace sigslot {
 
         private:
             std::decay_t<WeakPtr> ptr;
+            const obj_ptr target;       // object of ptr, told apart from aliases of its owner
             std::decay_t<Pmf> pmf;
         };
 
@@ -1537,16 +2875,23 @@ namespace sigslot {
         using lock_type = std::unique_lock<Lockable>;
         using slot_base = detail::slot_base<T...>;
         using slot_ptr = detail::slot_ptr<T...>;
-        using slots_type = std::vector<slot_ptr>;
+        using slots_type = std::vector<slot_ptr, counting_allocator<slot_ptr, detail::slot_list_memory>>;
         struct group_type { slots_type slts; group_id gid; };
-        using list_type = std::vector<group_type>;  // kept ordered by ascending gid
+        using list_type = std::vector<group_type, counting_allocator<group_type, detail::slot_list_memory>>;  // kept ordered by ascending gid
 
     public:
         using arg_list = trait::typelist<T...>;
         using ext_arg_list = trait::typelist<connection&, T...>;
 
-        signal_base() noexcept : m_block(false) {}
+        signal_base() noexcept : m_block(false) {
+            register_graph();
+        }
+
         ~signal_base() override {
+            if (m_graphed) {
+                detail::graph_registry::instance().remove(this);
+            }
+            emission_batch::discard(this);
             disconnect_all();
         }
 
@@ -1556,9 +2901,12 @@ namespace sigslot {
         signal_base(signal_base&& o) /* not noexcept */
         : m_block{o.m_block.load()}
         {
+            register_graph();
             lock_type lock(o.m_mutex);
             using std::swap;
             swap(m_slots, o.m_slots);
+            m_tracked.store(o.m_tracked.load());
+            m_metrics = std::move(o.m_metrics);
         }
 
         signal_base& operator=(signal_base&& o) /* not noexcept */ {
@@ -1569,6 +2917,8 @@ namespace sigslot {
             using std::swap;
             swap(m_slots, o.m_slots);
             m_block.store(o.m_block.exchange(m_block.load()));
+            m_tracked.store(o.m_tracked.exchange(m_tracked.load()));
+            m_metrics = std::move(o.m_metrics);
             return *this;
         }
 
@@ -1580,11 +2930,22 @@ namespace sigslot {
          *         multiple threads simultaneously. The guarantees only apply to the
          *         signal object, it does not cover thread safety of potentially
          *         shared state used in slot functions.
+         *          * Inside an emission_batch scope, the emission is recorded and delivered
+         * when the batch is flushed.
          *          * @param a... arguments to emit
          */
         template <typename... U>
         void operator()(U&& ...a) const {
             if (m_block) {
+                if (m_metrics) {
+                    m_metrics->count.fetch_add(1, std::memory_order_relaxed);
+                    m_metrics->drops.fetch_add(1, std::memory_order_relaxed);
+                }
+                return;
+            }
+
+            if (auto *batch = emission_batch::current()) {
+                batch->template record<signal_base, T...>(*this, std::forward<U>(a)...);
                 return;
             }
 
@@ -1592,6 +2953,18 @@ namespace sigslot {
            // a copy may occur if another thread writes to it.
             cow_copy_type<list_type, Lockable> ref = slots_reference();
 
+            // tracked objects are pinned once for the whole emission, by the
+            // signals holding or having held tracked slots only
+            std::optional<detail::tracked_pins> pins;
+            if (m_tracked.load(std::memory_order_relaxed)) {
+                pins.emplace();
+            }
+
+            if (m_metrics) {
+                emit_metered(detail::cow_read(ref), a...);
+                return;
+            }
+
             for (const auto& group : detail::cow_read(ref)) {
                 for (const auto& s : group.slts) {
                     s->operator()(a...);
@@ -1599,6 +2972,43 @@ namespace sigslot {
             }
         }
 
+        /**
+         * Publish the emissions of this signal to the stats region
+         *          * Effect: Subsequent emissions count the slots they reach, the
+         *         emissions reaching none or made while blocked as drops, and
+         *         the time spent emitting, see core::Metrics. Emitting stays
+         *         lock free. Does nothing unless metrics are enabled.
+         * Safety: Not thread safe, instrument before emitting.
+         *          * @param name the name shown by sigslot_top, truncated to 55 characters
+         * @return false if metrics are off or the stats region is full
+         */
+        bool instrument(std::string_view name) {
+            m_metrics = core::MetricsHandle::Acquire(core::MetricsKind::kSignal, name);
+            return static_cast<bool>(m_metrics);
+        }
+
+        bool instrumented() const noexcept {
+            return static_cast<bool>(m_metrics);
+        }
+
+        /**
+         * Emit a signal on a task queue
+         *          * Effect: The arguments are moved once into a single task posted to queue,
+         *         which then performs the whole emission, direct slots included,
+         *         as if the signal had been emitted by that queue. The calling
+         *         thread only pays for the post.
+         * Safety: The signal must outlive the posted task.
+         *          * @param queue the task queue performing the emission
+         * @param a... arguments to emit
+         */
+        template <typename... U>
+        void emit_on(core::TaskQueue* queue, U&& ...a) const {
+            assert(queue);
+            queue->PostTask([this, args = std::tuple<std::decay_t<T>...>(std::forward<U>(a)...)]() mutable {
+                std::apply(*this, std::move(args));
+            });
+        }
+
         /**
          * Connect a callable of compatible arguments
          *          * Effect: Creates and stores a new slot responsible for executing the
@@ -1612,6 +3022,9 @@ namespace sigslot {
         std::enable_if_t<trait::is_callable_v<arg_list, Callable>, connection>
         connect(Callable&& c, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot<Callable, T...>;
+            if (!accepts(type, queue)) {
+                return connection();
+            }
             auto s = make_slot<slot_t>(std::forward<Callable>(c), type, queue, gid);
             auto o = get_slot([&](const auto& slot) {
                 return slot->has_callable(c);
@@ -1641,6 +3054,9 @@ namespace sigslot {
         std::enable_if_t<trait::is_callable_v<ext_arg_list, Callable>, connection>
         connect_extended(Callable&& c, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot_extended<Callable, T...>;
+            if (!accepts(type, queue)) {
+                return connection();
+            }
             auto s = make_slot<slot_t>(std::forward<Callable>(c), type, queue, gid);
             auto o = get_slot([&](const auto& slot) {
                 return slot->has_callable(c);
@@ -1672,6 +3088,9 @@ namespace sigslot {
                              trait::is_observer_v<Ptr>, connection>
         connect(Ptr&& ptr, Pmf&& pmf, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot_pmf<Ptr, Pmf, T...>;
+            if (!accepts(type, queue)) {
+                return connection();
+            }
             auto s = make_slot<slot_t>(std::forward<Ptr>(ptr), std::forward<Pmf>(pmf), type, queue, gid);
             auto o = get_slot([&](const auto& slot) {
                 return slot->has_object(ptr) && slot->has_callable(pmf);
@@ -1703,6 +3122,9 @@ namespace sigslot {
                              !trait::is_weak_ptr_compatible_v<Ptr>, connection>
         connect(Ptr&& ptr, Pmf&& pmf, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
             using slot_t = detail::slot_pmf<Ptr, Pmf, T...>;
+            if (!accepts(type, queue)) {
+                return connection();
+            }
             auto s = make_slot<slot_t>(std::forward<Ptr>(ptr), std::forward<Pmf>(pmf), type, queue, gid);
             auto o = get_slot([&](const auto& slot) {
                 return slot->has_object(ptr) && slot->has_callable(pmf);
@@ -1731,7 +3153,10 @@ namespace sigslot {
         std::enable_if_t<trait::is_callable_v<ext_arg_list, Ptr, Pmf> &&
                              !trait::is_weak_ptr_compatible_v<Ptr>, connection>
         connect_extended(Pmf&& pmf, Ptr&& ptr, uint32_t type = connection_type::direct_connection, core::TaskQueue* queue = nullptr, group_id gid = 0) {
-            using slot_t = detail::slot_pmf_extended<Pmf, Ptr, T...>;
+            using slot_t = detail::slot_pmf_extended<Ptr, Pmf, T...>;
+            if (!accepts(type, queue)) {
+                return connection();
+            }
             auto s = make_slot<slot_t>(std::forward<Ptr>(ptr), std::forward<Pmf>(pmf), type, queue, gid);
             auto o = get_slot([&](const auto& slot) {
                 return slot->has_object(ptr) && slot->has_callable(pmf);
@@ -1770,6 +3195,9 @@ namespace sigslot {
             using trait::to_weak;
             auto w = to_weak(std::forward<Ptr>(ptr));
             using slot_t = detail::slot_pmf_tracked<Pmf, decltype(w), T...>;
+            if (!accepts(type, queue)) {
+                return connection();
+            }
             auto s = make_slot<slot_t>(w, std::forward<Pmf>(pmf), type, queue, gid);
             auto o = get_slot([&](const auto& slot) {
                 return slot->has_object(ptr) && slot->has_callable(pmf);
@@ -1807,6 +3235,9 @@ namespace sigslot {
             using trait::to_weak;
             auto w = to_weak(std::forward<Trackable>(ptr));
             using slot_t = detail::slot_tracked<Callable, decltype(w), T...>;
+            if (!accepts(type, queue)) {
+                return connection();
+            }
             auto s = make_slot<slot_t>(w, std::forward<Callable>(c), type, queue, gid);
             auto o = get_slot([&](const auto& slot) {
                 return slot->has_callable(c);
@@ -1833,6 +3264,139 @@ namespace sigslot {
             return connect(std::forward<CallArgs>(args)...);
         }
 
+        /**
+         * Creates a changed_only connection whose emissions are compared through
+         * a user supplied key instead of the whole argument tuple.
+         *          * Effect: the slot is only called when key(args...) differs from the key
+         *         of the last emission delivered to it. Suppressed emissions are
+         *         dropped before any task is posted to the slot queue.
+         * Use the same semantics as connect for the remaining arguments.
+         *          * @param key a callable returning an equality comparable value (a field,
+         *            a hash...) from the emitted arguments
+         * @return a connection object that can be used to interact with the slot
+         */
+        template <typename KeyFn, typename... CallArgs>
+        connection connect_distinct(KeyFn&& key, CallArgs&& ...args) {
+            using filter_t = detail::changed_filter<std::decay_t<KeyFn>, T...>;
+            return connect_with([&](slot_base& s) {
+                s.set_filter(std::make_unique<filter_t>(std::forward<KeyFn>(key)));
+            }, std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Creates a rate limited connection
+         *          * Effect: emissions are throttled, debounced or sampled according to limit
+         *         before being dispatched to the slot, see rate_limit. The state
+         *         is kept in the slot and emissions do not allocate.
+         * Use the same semantics as connect for the remaining arguments. A queue
+         * must be supplied for the trailing throttle and debounce modes, the
+         * connection is refused otherwise.
+         *          * @param limit the rate limit of the connection
+         * @return a connection object that can be used to interact with the slot
+         */
+        template <typename... CallArgs>
+        connection connect_limited(const rate_limit& limit, CallArgs&& ...args) {
+            using limiter_t = detail::rate_limiter<T...>;
+            return connect_with({[&](slot_base& s) {
+                s.set_limiter(std::make_unique<limiter_t>(limit, s.clock()));
+            }, limiter_t::needs_queue(limit)}, std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Creates a queued connection backed by a single producer channel
+         *          * Effect: the emissions of the first emitting thread are stored in a
+         *         bounded ring of capacity entries, drained by the slot queue in
+         *         batches, without lock nor allocation per emission. Emissions
+         *         from other threads, and the ones finding the ring full, take
+         *         the regular queued path. Deliveries of the producer thread
+         *         stay in order.
+         * Use the same semantics as connect for the remaining arguments, which
+         * must designate a queued connection and its queue.
+         *          * @param capacity the number of emissions the ring can hold, rounded up
+         *                 to a power of two
+         * @return a connection object that can be used to interact with the slot
+         */
+        template <typename... CallArgs>
+        connection connect_spsc(std::size_t capacity, CallArgs&& ...args) {
+            return connect_with([&](slot_base& s) {
+                s.set_channel(std::make_unique<detail::spsc_ring<T...>>(capacity));
+            }, std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Creates a queued connection overflowing to disk
+         *          * Effect: while the slot queue holds options.max_pending tasks or more,
+         *         deliveries are encoded with codec<T...> into memory mapped spill
+         *         files instead of being posted, and read back in order by the
+         *         queue once it caught up. Memory stays bounded and deliveries
+         *         stay in order, at the cost of encoding the spilled ones. Only
+         *         deliveries failing to be written behind spilled ones are
+         *         dropped, see spill_options. Deliveries
+         *         are posted normally again once the spill files are drained. The
+         *         queue must report its depth, see TaskQueueBase::PendingTasks().
+         * Use the same semantics as connect for the remaining arguments, which
+         * must designate a queued connection and its queue.
+         *          * @param options the budget and files of the spill, see spill_options
+         * @return a connection object that can be used to interact with the slot
+         */
+        template <typename... CallArgs>
+        connection connect_spilling(const spill_options& options, CallArgs&& ...args) {
+            return connect_with([&](slot_base& s) {
+                s.set_spill(std::make_unique<detail::spill_buffer<T...>>(options));
+            }, std::forward<CallArgs>(args)...);
+        }
+
+        /**
+         * Creates a queued connection spread over a group of task queues
+         *          * Effect: each emission is delivered on the queue of the group owning
+         *         key(args...), by consistent hashing. Emissions sharing a key are
+         *         delivered in order on a same queue, while distinct keys are
+         *         delivered in parallel on the queues of the group.
+         *          * @param group the group of queues, see core::TaskQueueManager::createGroup
+         * @param key a callable returning a hashable value from the emitted arguments
+         * @param args the callable, or the object and member function, to connect
+         * @return a connection object that can be used to interact with the slot
+         */
+        template <typename KeyFn, typename... CallArgs>
+        connection connect_keyed(core::TaskQueueGroup* group, KeyFn&& key, CallArgs&& ...args) {
+            using router_t = detail::keyed_router<std::decay_t<KeyFn>, T...>;
+            assert(group);
+            return connect_with([&](slot_base& s) {
+                s.set_router(std::make_unique<router_t>(*group, std::forward<KeyFn>(key)));
+            }, std::forward<CallArgs>(args)..., connection_type::queued_connection);
+        }
+
+        /**
+         * Creates a queued connection balanced over a set of task queues
+         *          * Effect: each emission is delivered on one of the queues, picked per
+         *         delivery according to policy. Deliveries are not ordered with
+         *         respect to each other, hence this fits stateless slots.
+         *          * @param queues the queues to deliver on, they must outlive the connection
+         * @param policy how the queue of a delivery is picked, see balance_policy
+         * @param args the callable, or the object and member function, to connect
+         * @return a connection object that can be used to interact with the slot
+         */
+        template <typename... CallArgs>
+        connection connect_balanced(std::vector<core::TaskQueue*> queues, balance_policy policy, CallArgs&& ...args) {
+            assert(!queues.empty());
+            return connect_with([&](slot_base& s) {
+                s.set_router(std::make_unique<detail::balanced_router<T...>>(std::move(queues), policy));
+            }, std::forward<CallArgs>(args)..., connection_type::queued_connection);
+        }
+
+        /**
+         * Overload of connect_balanced using the queues of a group
+         */
+        template <typename... CallArgs>
+        connection connect_balanced(core::TaskQueueGroup* group, balance_policy policy, CallArgs&& ...args) {
+            assert(group);
+            std::vector<core::TaskQueue*> queues;
+            for (std::size_t i = 0; i < group->Size(); ++i) {
+                queues.push_back(group->At(i));
+            }
+            return connect_balanced(std::move(queues), policy, std::forward<CallArgs>(args)...);
+        }
+
         /**
          * Disconnect slots bound to a callable
          *          * Effect: Disconnects all the slots bound to the callable in argument.
@@ -1899,15 +3463,18 @@ namespace sigslot {
          * @return the number of disconnected slots
          */
         size_t disconnect(group_id gid) {
-            lock_type lock(m_mutex);
-            for (auto& group : detail::cow_write(m_slots)) {
-                if (group.gid == gid) {
-                    size_t count = group.slts.size();
-                    group.slts.clear();
-                    return count;
+            slots_type removed;
+            {
+                lock_type lock(m_mutex);
+                for (auto& group : detail::cow_write(m_slots)) {
+                    if (group.gid == gid) {
+                        removed.swap(group.slts);
+                        break;
+                    }
                 }
             }
-            return 0;
+            purge_deliveries(removed);
+            return removed.size();
         }
 
         /**
@@ -1915,8 +3482,12 @@ namespace sigslot {
          * Safety: Thread safety depends on locking policy
          */
         void disconnect_all() {
-            lock_type lock(m_mutex);
-            clear();
+            slots_type removed;
+            {
+                lock_type lock(m_mutex);
+                removed = clear();
+            }
+            purge_deliveries(removed);
         }
 
         /**
@@ -1942,6 +3513,14 @@ namespace sigslot {
             return m_block.load();
         }
 
+        /**
+         * The lock guarding the slots, for instance to read the counters of an
+         * instrumented_lock
+         */
+        Lockable& lockable() const noexcept {
+            return m_mutex;
+        }
+
         /**
          * Get number of connected slots
          * Safety: thread safe
@@ -1982,16 +3561,64 @@ namespace sigslot {
         }
 
     private:
+        // applied by connect_with() to the slot being created, before it is added
+        struct slot_setup {
+            std::function<void(slot_base&)> apply;
+            bool needs_queue;   // refused without a queue, see accepts()
+        };
+
         // used to get a reference to the slots for reading
         inline cow_copy_type<list_type, Lockable> slots_reference() const {
             lock_type lock(m_mutex);
             return m_slots;
         }
 
-        // create a new slot
+        // changed_only connections compare the emitted arguments with operator==,
+        // they are refused for arguments that cannot be, see connect_distinct().
+        // Setups deferring deliveries are refused without a queue, see connect_limited()
+        static bool accepts(uint32_t type, const core::TaskQueue *queue) noexcept {
+            if (s_setup && s_setup->needs_queue && !queue) {
+                return false;
+            }
+            return trait::is_equality_comparable_v<T...> || !(type & connection_type::changed_only);
+        }
+
+        // create a new slot, with the setup pending from connect_with() if any
         template <typename Slot, typename... A>
         inline auto make_slot(A&& ...a) {
-            return detail::make_shared<slot_base, Slot>(*this, std::forward<A>(a)...);
+            // taken first, so connections made while the slot is constructed or
+            // set up do not inherit it
+            const slot_setup *setup = std::exchange(s_setup, nullptr);
+            auto s = detail::make_shared<slot_base, Slot>(*this, std::forward<A>(a)...);
+            if (m_graphed) {
+                s->count_deliveries();
+            }
+            if (detail::cpu_profile_registry::instance().enabled()) {
+                s->profile_cpu();
+            }
+            if (setup) {
+                setup->apply(*s);
+            }
+            return s;
+        }
+
+        // connect through the regular connect overloads, applying setup to the
+        // new slot before it becomes visible to emitting threads
+        template <typename Setup, typename... CallArgs>
+        connection connect_with(Setup&& setup, CallArgs&& ...args) {
+            return connect_with(slot_setup{std::forward<Setup>(setup), false}, std::forward<CallArgs>(args)...);
+        }
+
+        template <typename... CallArgs>
+        connection connect_with(slot_setup&& setup, CallArgs&& ...args) {
+            // restored even if connect() throws, never left pointing to setup
+            struct restore {
+                const slot_setup *prev;
+                ~restore() { s_setup = prev; }
+            };
+
+            const restore _{std::exchange(s_setup, &setup)};
+            return connect(std::forward<CallArgs>(args)...);
         }
 
         // add the slot to the list of slots of the right group
@@ -2013,6 +3640,9 @@ namespace sigslot {
             }
 
             // add the slot
+            if (s->pins_object()) {
+                m_tracked.store(true, std::memory_order_relaxed);
+            }
             s->index() = it->slts.size();
             it->slts.push_back(std::move(s));
         }
@@ -2058,38 +3688,120 @@ namespace sigslot {
         // disconnect a slot if a condition occurs
         template <typename Cond>
         size_t disconnect_if(Cond&& cond) {
-            lock_type lock(m_mutex);
-            auto& groups = detail::cow_write(m_slots);
-
-            size_t count = 0;
-
-            for (auto& group : groups) {
-                auto& slts = group.slts;
-                size_t i = 0;
-                while (i < slts.size()) {
-                    if (cond(slts[i])) {
-                        std::swap(slts[i], slts.back());
-                        slts[i]->index() = i;
-                        slts.pop_back();
-                        ++count;
-                    } else {
-                        ++i;
+            slots_type removed;
+            {
+                lock_type lock(m_mutex);
+                auto& groups = detail::cow_write(m_slots);
+
+                for (auto& group : groups) {
+                    auto& slts = group.slts;
+                    size_t i = 0;
+                    while (i < slts.size()) {
+                        if (cond(slts[i])) {
+                            std::swap(slts[i], slts.back());
+                            slts[i]->index() = i;
+                            removed.push_back(std::move(slts.back()));
+                            slts.pop_back();
+                        } else {
+                            ++i;
+                        }
                     }
                 }
             }
 
-            return count;
+            purge_deliveries(removed);
+            return removed.size();
         }
 
         // to be called under lock: remove all the slots
-        void clear() {
+        slots_type clear() {
+            slots_type removed;
+            for (auto& group : detail::cow_write(m_slots)) {
+                std::move(group.slts.begin(), group.slts.end(), std::back_inserter(removed));
+            }
             detail::cow_write(m_slots).clear();
+            return removed;
+        }
+
+        // drop the queued deliveries still pending for removed slots, with a
+        // single pass over each of the queues involved
+        static void purge_deliveries(slots_type& removed) {
+            using posted_type = std::tuple<core::TaskQueue*, const void*, slot_base*>;
+            std::vector<posted_type> posted;
+            for (auto& s : removed) {
+                s->for_pending_queues([&posted, &s](core::TaskQueue *queue) {
+                    posted.emplace_back(queue, s->delivery_tag(), s.get());
+                });
+            }
+            std::sort(posted.begin(), posted.end());
+
+            auto it = posted.begin();
+            while (it != posted.end()) {
+                auto *queue = std::get<0>(*it);
+                auto end = std::find_if(it, posted.end(), [queue](const auto& p) {
+                    return std::get<0>(p) != queue;
+                });
+                queue->PurgeTasksIf([it, end](const void *tag) {
+                    auto found = std::lower_bound(it, end, tag, [](const auto& p, const void *t) {
+                        return std::less<const void*>{}(std::get<1>(p), t);
+                    });
+                    if (found == end || std::get<1>(*found) != tag) {
+                        return false;
+                    }
+                    std::get<2>(*found)->purged();
+                    return true;
+                });
+                it = end;
+            }
         }
 
     private:
+        // track the signal in the connection graph, if enabled
+        void register_graph() {
+            auto& registry = detail::graph_registry::instance();
+            if (registry.enabled()) {
+                registry.add(this, [this](std::vector<graph_edge>& edges) {
+                    cow_copy_type<list_type, Lockable> ref = slots_reference();
+                    for (const auto& group : detail::cow_read(ref)) {
+                        for (const auto& s : group.slts) {
+                            edges.emplace_back();
+                            s->describe(edges.back());
+                        }
+                    }
+                });
+                m_graphed = true;
+            }
+        }
+
+        template <typename... A>
+        void emit_metered(const list_type& groups, A& ...a) const {
+            const auto start = std::chrono::steady_clock::now();
+            std::uint64_t reached = 0;
+            for (const auto& group : groups) {
+                for (const auto& s : group.slts) {
+                    if (s->connected() && !s->blocked()) {
+                        ++reached;
+                    }
+                    s->operator()(a...);
+                }
+            }
+            m_metrics->count.fetch_add(1, std::memory_order_relaxed);
+            m_metrics->deliveries.fetch_add(reached, std::memory_order_relaxed);
+            if (reached == 0) {
+                m_metrics->drops.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_metrics->run.Record(std::chrono::steady_clock::now() - start);
+        }
+
+        // setup pending for the slot being created by connect_with() on this thread
+        static inline thread_local const slot_setup *s_setup = nullptr;
+
         mutable Lockable m_mutex;
         cow_type<list_type, Lockable> m_slots;
         std::atomic<bool> m_block;
+        std::atomic<bool> m_tracked{false};     // a tracked slot was added, see tracked_pins
+        core::MetricsHandle m_metrics;
+        bool m_graphed = false;
     };
 
 
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "signal.hpp"
+
+namespace sigslot {
+
+    /**
+     * slot_profiler accounts the thread CPU time spent in each slot, called
+     * directly by the emitting thread or from a task queue, to tell which
+     * subscribers actually burn the cores. Unlike the wall time, also reported,
+     * the CPU time does not grow while the slot is preempted or blocked.
+     *      * Profiling is opt-in and process wide: slots connected once it is enabled
+     * read the thread CPU clock around each call, see core::ThreadCpuTime(),
+     * and add it to a table of the calling thread. Tables are merged on demand
+     * by snapshot(). Slots connected before enable() are not profiled.
+     */
+    class slot_profiler {
+    public:
+        /**
+         * Profile the slots connected from now on
+         */
+        static void enable() noexcept {
+            detail::cpu_profile_registry::instance().enable();
+        }
+
+        /**
+         * Stop profiling the slots connected from now on, the profiled ones keep
+         * being accounted until disconnected
+         */
+        static void disable() noexcept {
+            detail::cpu_profile_registry::instance().disable();
+        }
+
+        static bool enabled() noexcept {
+            return detail::cpu_profile_registry::instance().enabled();
+        }
+
+        /**
+         * Forget the time accounted so far
+         */
+        static void reset() {
+            detail::cpu_profile_registry::instance().reset();
+        }
+
+        /**
+         * Time spent per connection and per queue it ran on, the most CPU
+         * consuming first. Callable types are demangled where possible.
+         */
+        static std::vector<slot_cpu_stats> snapshot() {
+            auto stats = detail::cpu_profile_registry::instance().merge();
+            for (auto& s : stats) {
+                s.callable = detail::demangle(s.callable);
+            }
+            sort(stats);
+            return stats;
+        }
+
+        /**
+         * Time spent per callable type, over all connections and queues
+         */
+        static std::vector<slot_cpu_stats> by_callable() {
+            std::map<std::string, slot_cpu_stats> merged;
+            for (auto& s : snapshot()) {
+                auto& m = merged[s.callable];
+                if (m.calls == 0) {
+                    m.callable = s.callable;
+                    m.type = s.type;
+                }
+                m.calls += s.calls;
+                m.cpu += s.cpu;
+                m.wall += s.wall;
+            }
+            std::vector<slot_cpu_stats> stats;
+            stats.reserve(merged.size());
+            for (auto& m : merged) {
+                stats.push_back(std::move(m.second));
+            }
+            sort(stats);
+            return stats;
+        }
+
+        /**
+         * Text table of the top entries of stats
+         */
+        static std::string report(const std::vector<slot_cpu_stats>& stats, std::size_t top = 20) {
+            std::string out;
+            char line[256];
+            std::snprintf(line, sizeof(line), "%12s %12s %12s %10s  %-20s %s\n",
+                          "CPU ms", "WALL ms", "CALLS", "CPU us/call", "QUEUE", "CALLABLE");
+            out += line;
+            for (std::size_t i = 0; i < stats.size() && i < top; ++i) {
+                auto& s = stats[i];
+                const double cpu = std::chrono::duration<double, std::milli>(s.cpu).count();
+                const double wall = std::chrono::duration<double, std::milli>(s.wall).count();
+                std::snprintf(line, sizeof(line), "%12.3f %12.3f %12llu %10.2f  %-20.20s ",
+                              cpu, wall, static_cast<unsigned long long>(s.calls),
+                              s.calls ? cpu * 1000.0 / static_cast<double>(s.calls) : 0.0,
+                              s.queue.empty() ? "-" : s.queue.c_str());
+                out += line;
+                out += (s.callable.empty() ? std::string("?") : s.callable) + "\n";
+            }
+            return out;
+        }
+
+    private:
+        static void sort(std::vector<slot_cpu_stats>& stats) {
+            std::sort(stats.begin(), stats.end(), [](const slot_cpu_stats& a, const slot_cpu_stats& b) {
+                return a.cpu > b.cpu;
+            });
+        }
+    };
+
+} // namespace sigslot
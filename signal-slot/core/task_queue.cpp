@@ -1,13 +1,87 @@
+#include <algorithm>
+#include <mutex>
+#include <vector>
 #include "task_queue.hpp"
 #include "task_queue_base.hpp"
 #include "task_queue_stdlib.hpp"
+#include "task_queue_sharded.hpp"
+#include "task_queue_epoll.hpp"
+#include "task_queue_simulated.hpp"
 
 namespace core {
 
+    namespace {
+
+        // Runs a task and publishes its wait and run times to the entry of its
+        // queue. Only the worker of the queue runs it, so the entry has a single
+        // writer and stays lock free.
+        class MeteredTask : public QueuedTask {
+        public:
+            MeteredTask(std::unique_ptr<QueuedTask> task, TaskQueueBase* queue, MetricsHandle* metrics,
+                        Clock::TimePoint due)
+            : task_(std::move(task)), queue_(queue), metrics_(metrics), due_(due) {
+                set_tag(task_->tag());
+            }
+
+        private:
+            bool run() override {
+                const Clock& clock = queue_->GetClock();
+                const auto start = clock.Now();
+                if (!task_->run()) {
+                    // the task took its own ownership back
+                    task_.release();
+                }
+                const auto end = clock.Now();
+
+                auto& metrics = *metrics_;
+                metrics.BeginWrite();
+                metrics->wait.Record(start - due_);
+                metrics->run.Record(end - start);
+                metrics->count.store(metrics->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                metrics->depth.store(queue_->PendingTasks(), std::memory_order_relaxed);
+                metrics.EndWrite();
+                return true;
+            }
+
+            size_t footprint() const override {
+                return sizeof(*this) + task_->footprint();
+            }
+
+            std::unique_ptr<QueuedTask> task_;
+            TaskQueueBase* const queue_;
+            MetricsHandle* const metrics_;
+            const Clock::TimePoint due_;
+        };
+
+        // The live queues, for MemoryUsageOfAll(). Never destroyed, queues
+        // owned by statics may be destroyed after the exit handlers ran.
+        struct LiveQueues {
+            std::mutex mutex;
+            std::vector<const TaskQueue*> queues;
+        };
+
+        LiveQueues& Live() {
+            static auto* live = new LiveQueues;
+            return *live;
+        }
+
+    }  // namespace
+
     TaskQueue::TaskQueue(std::unique_ptr<TaskQueueBase, TaskQueueDeleter> taskQueue)
-    : impl_(taskQueue.release()) {}
+    : impl_(taskQueue.release())
+    , metrics_(MetricsHandle::Acquire(MetricsKind::kQueue, impl_->Name())) {
+        auto& live = Live();
+        std::lock_guard<std::mutex> lock(live.mutex);
+        live.queues.push_back(this);
+    }
 
     TaskQueue::~TaskQueue() {
+        {
+            auto& live = Live();
+            std::lock_guard<std::mutex> lock(live.mutex);
+            live.queues.erase(std::find(live.queues.begin(), live.queues.end(), this));
+        }
+        // the worker is stopped, no task updates the entry anymore
         impl_->Delete();
     }
 
@@ -15,16 +89,85 @@ namespace core {
         return impl_->IsCurrent();
     }
 
+    const std::string& TaskQueue::Name() const {
+        return impl_->Name();
+    }
+
     void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
+        if (metrics_) {
+            task = std::make_unique<MeteredTask>(std::move(task), impl_, &metrics_, impl_->GetClock().Now());
+        }
         return impl_->PostTask(std::move(task));
     }
 
     void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+        if (metrics_) {
+            task = std::make_unique<MeteredTask>(std::move(task), impl_, &metrics_, impl_->GetClock().Now() + delay);
+        }
         return impl_->PostDelayedTask(std::move(task), delay);
     }
 
+    size_t TaskQueue::PurgeTasks(const void* tag) {
+        return impl_->PurgeTasks(tag);
+    }
+
+    size_t TaskQueue::PurgeTasksIf(const std::function<bool(const void* tag)>& match) {
+        return impl_->PurgeTasksIf(match);
+    }
+
+    size_t TaskQueue::PendingTasks() const {
+        return impl_->PendingTasks();
+    }
+
+    TaskQueueMemory TaskQueue::MemoryUsage() const {
+        return impl_->MemoryUsage();
+    }
+
+    std::vector<std::pair<std::string, TaskQueueMemory>> TaskQueue::MemoryUsageOfAll() {
+        auto& live = Live();
+        std::lock_guard<std::mutex> lock(live.mutex);
+        std::vector<std::pair<std::string, TaskQueueMemory>> usage;
+        usage.reserve(live.queues.size());
+        for (auto* queue : live.queues) {
+            usage.emplace_back(queue->Name(), queue->MemoryUsage());
+        }
+        return usage;
+    }
+
+    bool TaskQueue::WatchReadable(int fd, std::function<void()> on_readable) {
+        return impl_->WatchReadable(fd, std::move(on_readable));
+    }
+
+    void TaskQueue::UnwatchReadable(int fd) {
+        impl_->UnwatchReadable(fd);
+    }
+
+    Clock& TaskQueue::GetClock() const {
+        return impl_->GetClock();
+    }
+
     std::unique_ptr<TaskQueue> TaskQueue::Create(std::string_view name) {
+        if (TaskQueueStdlib::LocksProfiled()) {
+            return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new ProfiledTaskQueueStdlib(name)));
+        }
         return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new TaskQueueStdlib(name)));
     }
 
+    std::unique_ptr<TaskQueue> TaskQueue::CreateSharded(std::string_view name, size_t shards) {
+        return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new TaskQueueSharded(name, shards)));
+    }
+
+    std::unique_ptr<TaskQueue> TaskQueue::CreateSimulated(std::string_view name, SimulatedClock& clock) {
+        return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new TaskQueueSimulated(name, clock)));
+    }
+
+    std::unique_ptr<TaskQueue> TaskQueue::CreateEpoll(std::string_view name) {
+#if defined(__linux__)
+        return std::make_unique<TaskQueue>(std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(new TaskQueueEpoll(name)));
+#else
+        (void)name;
+        return nullptr;
+#endif
+    }
+
 }
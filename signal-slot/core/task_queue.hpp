@@ -2,10 +2,17 @@
 
 #include <stdint.h>
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <chrono>
+#include <utility>
+#include <vector>
 #include "queued_task.hpp"
+#include "task_queue_base.hpp"
+#include "clock.hpp"
+#include "metrics.hpp"
 
 namespace core {
     // Implements a task queue that asynchronously executes tasks in a way that
@@ -53,12 +60,17 @@ namespace core {
 
     class TaskQueueBase;
     class TaskQueueDeleter;
+    class SimulatedClock;
 
     // When a TaskQueue is deleted, pending tasks will not be executed but they will
     // be deleted.  The deletion of tasks may happen asynchronously after the
     // TaskQueue itself has been deleted or it may happen synchronously while the
     // TaskQueue instance is being deleted.  This may vary from one OS to the next
     // so assumptions about lifetimes of pending tasks should not be made.
+    //
+    // Once Metrics are enabled, queues created afterwards publish their depth
+    // and the wait and run times of the tasks posted through them to the stats
+    // region, from their worker, see Metrics.
     class TaskQueue {
     public:
         explicit TaskQueue(std::unique_ptr<TaskQueueBase, TaskQueueDeleter> taskQueue);
@@ -66,9 +78,25 @@ namespace core {
 
         static std::unique_ptr<TaskQueue> Create(std::string_view name);
 
+        // Creates a queue with per-producer inboxes, for queues fed by many
+        // threads. Only the tasks of a same producer are run in FIFO order, see
+        // TaskQueueSharded. |shards| of 0 uses one inbox per hardware thread.
+        static std::unique_ptr<TaskQueue> CreateSharded(std::string_view name, size_t shards = 0);
+
+        // Creates a queue whose thread also waits for file descriptors to become
+        // readable, see TaskQueueEpoll. Returns nullptr where epoll is not available.
+        static std::unique_ptr<TaskQueue> CreateEpoll(std::string_view name);
+
+        // Creates a queue without a thread, whose tasks run when |clock| is
+        // advanced, for deterministic timing tests. See TaskQueueSimulated.
+        static std::unique_ptr<TaskQueue> CreateSimulated(std::string_view name, SimulatedClock& clock);
+
         // Used for DCHECKing the current queue.
         bool IsCurrent() const;
 
+        // Returns the name the queue was created with.
+        const std::string& Name() const;
+
         // Returns non-owning pointer to the task queue implementation.
         TaskQueueBase* Get() { return impl_; }
 
@@ -84,6 +112,29 @@ namespace core {
         // more likely). This can be mitigated by limiting the use of delayed tasks.
         void PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay);
 
+        // Drops the pending tasks tagged with |tag| (see QueuedTask::set_tag) or
+        // whose tag matches, without running them. Returns the number of dropped tasks.
+        size_t PurgeTasks(const void* tag);
+        size_t PurgeTasksIf(const std::function<bool(const void* tag)>& match);
+
+        // Returns the number of tasks ready to run or running, see
+        // TaskQueueBase::PendingTasks().
+        size_t PendingTasks() const;
+
+        // Returns the memory held by the waiting tasks, see
+        // TaskQueueBase::MemoryUsage().
+        TaskQueueMemory MemoryUsage() const;
+
+        // Returns the memory usage of every live queue, with its name.
+        static std::vector<std::pair<std::string, TaskQueueMemory>> MemoryUsageOfAll();
+
+        // Watches a file descriptor from the task queue, see
+        // TaskQueueBase::WatchReadable(). Needs a queue created with CreateEpoll.
+        bool WatchReadable(int fd, std::function<void()> on_readable);
+        void UnwatchReadable(int fd);
+
+        // Returns the clock of the queue, see TaskQueueBase::GetClock().
+        Clock& GetClock() const;
 
         // std::enable_if is used here to make sure that calls to PostTask() with
         // std::unique_ptr<SomeClassDerivedFromQueuedTask> would not end up being
@@ -106,6 +157,7 @@ namespace core {
 
     private:
         TaskQueueBase* const impl_;
+        MetricsHandle metrics_;
 
     };
 
@@ -1,12 +1,24 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <chrono>
 #include "queued_task.hpp"
+#include "clock.hpp"
 
 namespace core {
 
+    // Memory held by the tasks waiting in a queue, see
+    // TaskQueueBase::MemoryUsage().
+    struct TaskQueueMemory {
+        size_t pending_tasks = 0;    // ready to run, the running one excluded
+        size_t pending_bytes = 0;    // their QueuedTask::footprint()
+        size_t delayed_tasks = 0;    // not due yet
+        size_t delayed_bytes = 0;
+    };
+
     // Asynchronously executes tasks in a way that guarantees that they're executed
     // in FIFO order and that tasks never overlap. Tasks may always execute on the
     // same worker thread and they may not. To DCHECK that tasks are executing on a
@@ -42,6 +54,41 @@ namespace core {
 
         virtual void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) = 0;
 
+        // Drops the pending tasks, delayed ones included, whose tag matches. Tasks
+        // already running are not affected. The dropped tasks are deleted without
+        // being run, on the calling thread. Returns the number of dropped tasks.
+        // Implementations not supporting it drop nothing.
+        virtual size_t PurgeTasksIf(const std::function<bool(const void* tag)>& /*match*/) { return 0; }
+
+        size_t PurgeTasks(const void* tag) {
+            return PurgeTasksIf([tag](const void* t) { return t == tag; });
+        }
+
+        // Returns the number of tasks ready to run, the one running included.
+        // Delayed tasks are not accounted for until they are due. The value is
+        // a snapshot meant for load balancing, it may be stale as soon as read.
+        // Implementations not supporting it return 0.
+        virtual size_t PendingTasks() const { return 0; }
+
+        // Returns the count and footprint of the tasks waiting in the queue.
+        // Walks the tasks under the queue lock, meant for diagnostics rather
+        // than for every post. Implementations not supporting it return zeros.
+        virtual TaskQueueMemory MemoryUsage() const { return {}; }
+
+        // Calls |on_readable| on the task queue each time the file descriptor |fd|
+        // has data to read, until UnwatchReadable(fd). Returns false if |fd| is
+        // already watched or if the implementation does not support watching
+        // file descriptors, see TaskQueueEpoll.
+        virtual bool WatchReadable(int /*fd*/, std::function<void()> /*on_readable*/) { return false; }
+
+        // Stops watching |fd|. Once this returns on the task queue, |on_readable|
+        // is not called anymore.
+        virtual void UnwatchReadable(int /*fd*/) {}
+
+        // Returns the clock the delayed tasks of the queue are due against.
+        // Defaults to the real clock, see TaskQueueSimulated.
+        virtual Clock& GetClock() const { return Clock::Real(); }
+
         // Returns the task queue that is running the current thread.
         // Returns nullptr if this thread is not associated with any task queue.
         static TaskQueueBase* Current();
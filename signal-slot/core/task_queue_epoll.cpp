@@ -0,0 +1,231 @@
+#include "task_queue_epoll.hpp"
+
+#if defined(__linux__)
+
+#include <assert.h>
+#include <algorithm>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace core {
+
+    TaskQueueEpoll::TaskQueueEpoll(std::string_view queue_name)
+    : name_(queue_name) {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        assert(epoll_fd_ >= 0 && wake_fd_ >= 0);
+
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = wake_fd_;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+        thread_ = std::thread([this]{
+            CurrentTaskQueueSetter setCurrent(this);
+            this->ProcessTasks();
+        });
+    }
+
+    TaskQueueEpoll::~TaskQueueEpoll() {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        close(wake_fd_);
+        close(epoll_fd_);
+    }
+
+    void TaskQueueEpoll::Delete() {
+        assert(!IsCurrent());
+
+        thread_should_quit_ = true;
+        Wake();
+
+        delete this;
+    }
+
+    void TaskQueueEpoll::PostTask(std::unique_ptr<QueuedTask> task) {
+        {
+            std::unique_lock<std::mutex> lock(pending_lock_);
+            pending_queue_.push_back(std::move(task));
+            ++pending_count_;
+        }
+
+        Wake();
+    }
+
+    void TaskQueueEpoll::PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+        DelayedEntryTimeout delayed_entry;
+        delayed_entry.next_fire_at = std::chrono::steady_clock::now() + delay;
+
+        {
+            std::unique_lock<std::mutex> lock(pending_lock_);
+            delayed_entry.order = ++delayed_order_;
+            delayed_queue_[delayed_entry] = std::move(task);
+        }
+
+        Wake();
+    }
+
+    void TaskQueueEpoll::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+        PostDelayedTask(std::move(task), delay);
+    }
+
+    size_t TaskQueueEpoll::PurgeTasksIf(const std::function<bool(const void* tag)>& match) {
+        // purged tasks are deleted out of the lock, their destruction may post tasks
+        std::vector<std::unique_ptr<QueuedTask>> purged;
+
+        {
+            std::unique_lock<std::mutex> lock(pending_lock_);
+
+            for (auto& task : pending_queue_) {
+                if (match(task->tag())) {
+                    purged.push_back(std::move(task));
+                }
+            }
+            if (!purged.empty()) {
+                pending_queue_.erase(std::remove(pending_queue_.begin(), pending_queue_.end(), nullptr),
+                                     pending_queue_.end());
+                pending_count_ -= purged.size();
+            }
+
+            for (auto it = delayed_queue_.begin(); it != delayed_queue_.end();) {
+                if (match(it->second->tag())) {
+                    purged.push_back(std::move(it->second));
+                    it = delayed_queue_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        return purged.size();
+    }
+
+    size_t TaskQueueEpoll::PendingTasks() const {
+        return pending_count_.load(std::memory_order_relaxed);
+    }
+
+    bool TaskQueueEpoll::WatchReadable(int fd, std::function<void()> on_readable) {
+        std::unique_lock<std::mutex> lock(pending_lock_);
+        if (watchers_.count(fd)) {
+            return false;
+        }
+
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            return false;
+        }
+        watchers_[fd] = std::make_shared<std::function<void()>>(std::move(on_readable));
+        return true;
+    }
+
+    void TaskQueueEpoll::UnwatchReadable(int fd) {
+        std::unique_lock<std::mutex> lock(pending_lock_);
+        if (watchers_.erase(fd)) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        }
+    }
+
+    TaskQueueMemory TaskQueueEpoll::MemoryUsage() const {
+        TaskQueueMemory usage;
+        std::unique_lock<std::mutex> lock(pending_lock_);
+        usage.pending_tasks = pending_queue_.size();
+        for (auto& task : pending_queue_) {
+            usage.pending_bytes += task->footprint();
+        }
+        usage.delayed_tasks = delayed_queue_.size();
+        for (auto& entry : delayed_queue_) {
+            usage.delayed_bytes += entry.second->footprint();
+        }
+        return usage;
+    }
+
+    const std::string& TaskQueueEpoll::Name() const {
+        return name_;
+    }
+
+    int TaskQueueEpoll::RunReadyTasks() {
+        // run the tasks posted so far, then the delayed tasks that are due
+        std::deque<std::unique_ptr<QueuedTask>> ready;
+        {
+            std::unique_lock<std::mutex> lock(pending_lock_);
+            ready.swap(pending_queue_);
+
+            auto now = std::chrono::steady_clock::now();
+            while (!delayed_queue_.empty() && delayed_queue_.begin()->first.next_fire_at <= now) {
+                ready.push_back(std::move(delayed_queue_.begin()->second));
+                delayed_queue_.erase(delayed_queue_.begin());
+                ++pending_count_;
+            }
+        }
+
+        for (auto& task : ready) {
+            if (thread_should_quit_) {
+                break;
+            }
+            QueuedTask* release_ptr = task.release();
+            if (release_ptr->run()) {
+                delete release_ptr;
+            }
+            --pending_count_;
+        }
+
+        std::unique_lock<std::mutex> lock(pending_lock_);
+        if (!pending_queue_.empty()) {
+            return 0;
+        }
+        if (delayed_queue_.empty()) {
+            return -1;
+        }
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            delayed_queue_.begin()->first.next_fire_at - std::chrono::steady_clock::now());
+        return static_cast<int>(std::max<std::chrono::milliseconds::rep>(wait.count() + 1, 0));
+    }
+
+    void TaskQueueEpoll::ProcessTasks() {
+        constexpr int kMaxEvents = 64;
+        struct epoll_event events[kMaxEvents];
+
+        while (!thread_should_quit_) {
+            const int timeout = RunReadyTasks();
+            if (thread_should_quit_) {
+                break;
+            }
+
+            const int n = epoll_wait(epoll_fd_, events, kMaxEvents, timeout);
+            for (int i = 0; i < n && !thread_should_quit_; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == wake_fd_) {
+                    uint64_t count;
+                    while (read(wake_fd_, &count, sizeof(count)) > 0) {
+                    }
+                    continue;
+                }
+
+                Callback callback;
+                {
+                    std::unique_lock<std::mutex> lock(pending_lock_);
+                    auto it = watchers_.find(fd);
+                    if (it != watchers_.end()) {
+                        callback = it->second;
+                    }
+                }
+                if (callback) {
+                    (*callback)();
+                }
+            }
+        }
+    }
+
+    void TaskQueueEpoll::Wake() {
+        const uint64_t one = 1;
+        ssize_t r = write(wake_fd_, &one, sizeof(one));
+        (void)r;
+    }
+}
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <string>
+#include <map>
+#include <memory>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include "queued_task.hpp"
+#include "task_queue_base.hpp"
+#include "counting_allocator.hpp"
+
+namespace core {
+
+    // Task queue backend whose thread waits on an epoll instance, so that it can
+    // run the callbacks of readable file descriptors (sockets, pipes...) in
+    // between tasks. Posting a task wakes the thread up through an eventfd.
+    //
+    // Tasks run in FIFO order. Delayed tasks run once due, after the tasks
+    // posted before they became due. Watched descriptors are level triggered:
+    // their callback is called again as long as data is left to read.
+    class TaskQueueEpoll final : public TaskQueueBase {
+    public:
+        explicit TaskQueueEpoll(std::string_view queue_name);
+        ~TaskQueueEpoll() override;
+
+        void Delete() override;
+        void PostTask(std::unique_ptr<QueuedTask> task) override;
+        void PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
+        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
+        size_t PurgeTasksIf(const std::function<bool(const void* tag)>& match) override;
+        size_t PendingTasks() const override;
+        TaskQueueMemory MemoryUsage() const override;
+        bool WatchReadable(int fd, std::function<void()> on_readable) override;
+        void UnwatchReadable(int fd) override;
+        const std::string& Name() const override;
+
+    private:
+        using OrderId = uint64_t;
+        using TimePoint = std::chrono::steady_clock::time_point;
+        using Callback = std::shared_ptr<std::function<void()>>;
+
+        struct DelayedEntryTimeout {
+            TimePoint next_fire_at;
+            OrderId order{};
+
+            bool operator<(const DelayedEntryTimeout& o) const {
+                return std::tie(next_fire_at, order) < std::tie(o.next_fire_at, o.order);
+            }
+        };
+
+        // nodes accounted in sigslot::memory_stats()
+        using DelayedQueue = std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>, std::less<DelayedEntryTimeout>,
+            sigslot::counting_allocator<std::pair<const DelayedEntryTimeout, std::unique_ptr<QueuedTask>>,
+                                        sigslot::detail::delayed_node_memory>>;
+
+        void ProcessTasks();
+        int RunReadyTasks();
+        void Wake();
+
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+
+        mutable std::mutex pending_lock_;
+        OrderId delayed_order_{0};
+        std::deque<std::unique_ptr<QueuedTask>> pending_queue_;
+        DelayedQueue delayed_queue_;
+        std::unordered_map<int, Callback> watchers_;
+        std::atomic<size_t> pending_count_{0};
+        std::atomic<bool> thread_should_quit_{false};
+
+        std::thread thread_;
+        std::string name_;
+    };
+}
+
+#endif
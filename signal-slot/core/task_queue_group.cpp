@@ -0,0 +1,40 @@
+#include "task_queue_group.hpp"
+#include "task_queue.hpp"
+
+namespace core {
+
+    namespace {
+
+        // Jump consistent hash (Lamping & Veach), maps a key to a bucket in
+        // [0, buckets) with minimal movement when the number of buckets grows.
+        size_t JumpConsistentHash(uint64_t key, size_t buckets) {
+            int64_t b = -1;
+            int64_t j = 0;
+            while (j < static_cast<int64_t>(buckets)) {
+                b = j;
+                key = key * 2862933555777941757ULL + 1;
+                j = static_cast<int64_t>((b + 1) * (double(1LL << 31) / double((key >> 33) + 1)));
+            }
+            return static_cast<size_t>(b);
+        }
+
+    }
+
+    TaskQueueGroup::TaskQueueGroup(std::string_view name, size_t size)
+    : name_(name) {
+        if (size == 0) {
+            size = 1;
+        }
+        queues_.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            queues_.push_back(TaskQueue::Create(name_ + "#" + std::to_string(i)));
+        }
+    }
+
+    TaskQueueGroup::~TaskQueueGroup() = default;
+
+    TaskQueue* TaskQueueGroup::ForKey(uint64_t key) const {
+        return queues_[JumpConsistentHash(key, queues_.size())].get();
+    }
+
+}
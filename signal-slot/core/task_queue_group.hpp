@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core {
+
+    class TaskQueue;
+
+    // A fixed set of task queues sharing a name, used to spread work across
+    // threads while keeping the tasks of a same key in order.
+    //
+    // Tasks posted for a given key always land on the same queue, chosen by
+    // consistent hashing, so they run in FIFO order relative to each other while
+    // different keys run in parallel. The queues are named "<name>#<index>".
+    class TaskQueueGroup {
+    public:
+        TaskQueueGroup(std::string_view name, size_t size);
+        ~TaskQueueGroup();
+
+        const std::string& Name() const { return name_; }
+
+        size_t Size() const { return queues_.size(); }
+
+        // Returns the queue at |index|, which must be lower than Size().
+        TaskQueue* At(size_t index) const { return queues_[index].get(); }
+
+        // Returns the queue owning |key|, a hash of the user key. A key only moves
+        // to another queue when the group size changes, and then only when it
+        // moves to a new queue.
+        TaskQueue* ForKey(uint64_t key) const;
+
+    private:
+        TaskQueueGroup& operator=(const TaskQueueGroup&) = delete;
+        TaskQueueGroup(const TaskQueueGroup&) = delete;
+
+    private:
+        const std::string name_;
+        std::vector<std::unique_ptr<TaskQueue>> queues_;
+    };
+
+}
@@ -1,5 +1,6 @@
 #include "task_queue_manager.hpp"
 #include "task_queue.hpp"
+#include "task_queue_group.hpp"
 
 namespace core {
 
@@ -33,10 +34,21 @@ namespace core {
         }
     }
 
+    void TaskQueueManager::createSharded(const std::vector<std::string>& nameList, size_t shards)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (const auto& name : nameList) {
+            if (!exist(name)) {
+                m_queueMap[name] = TaskQueue::CreateSharded(name, shards);
+            }
+        }
+    }
+
     void TaskQueueManager::clear()
     {
         std::unique_lock<std::mutex> lock(m_mutex);
         m_queueMap.clear();
+        m_groupMap.clear();
     }
 
     bool TaskQueueManager::exist(const std::string& name)
@@ -56,4 +68,21 @@ namespace core {
         return exist(name) ? m_queueMap[name].get() : nullptr;
     }
 
+    TaskQueueGroup* TaskQueueManager::createGroup(const std::string& name, size_t count)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto& group = m_groupMap[name];
+        if (!group) {
+            group = std::make_unique<TaskQueueGroup>(name, count);
+        }
+        return group.get();
+    }
+
+    TaskQueueGroup* TaskQueueManager::group(const std::string& name)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_groupMap.find(name);
+        return it != m_groupMap.end() ? it->second.get() : nullptr;
+    }
+
 }
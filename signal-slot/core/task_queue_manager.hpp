@@ -9,6 +9,7 @@
 namespace core {
 
     class TaskQueue;
+    class TaskQueueGroup;
 
     class TaskQueueManager {
     public:
@@ -18,10 +19,19 @@ namespace core {
 
         void create(const std::vector<std::string>& nameList);
 
+        // Same as create, with queues suited to many producer threads, see
+        // TaskQueue::CreateSharded.
+        void createSharded(const std::vector<std::string>& nameList, size_t shards = 0);
+
         TaskQueue* queue(const std::string& name);
 
         bool hasQueue(const std::string& name);
 
+        // Creates a group of |count| queues, or returns the existing group |name|.
+        TaskQueueGroup* createGroup(const std::string& name, size_t count);
+
+        TaskQueueGroup* group(const std::string& name);
+
     private:
         void clear();
 
@@ -43,6 +53,8 @@ namespace core {
 
         std::unordered_map<std::string, std::unique_ptr<TaskQueue>> m_queueMap;
 
+        std::unordered_map<std::string, std::unique_ptr<TaskQueueGroup>> m_groupMap;
+
     };
 
 }
@@ -50,3 +62,5 @@ namespace core {
 #define TQMgr core::TaskQueueManager::instance()
 
 #define TQ(name) TQMgr->queue(name)
+
+#define TQG(name) TQMgr->group(name)
@@ -0,0 +1,268 @@
+#include "task_queue_sharded.hpp"
+#include <assert.h>
+#include <algorithm>
+#include <vector>
+
+namespace core {
+
+    namespace {
+
+        // index of the posting thread, binding it to a shard of every sharded queue
+        size_t ProducerIndex() {
+            static std::atomic<size_t> next_index{0};
+            thread_local const size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+
+    }  // namespace
+
+    TaskQueueSharded::TaskQueueSharded(std::string_view queue_name, size_t shards)
+    : shard_count_(shards ? shards : std::max(1u, std::thread::hardware_concurrency()))
+    , shards_(new Shard[shard_count_])
+    , name_(queue_name) {
+        thread_ = std::thread([this]{
+            CurrentTaskQueueSetter setCurrent(this);
+            this->ProcessTasks();
+        });
+    }
+
+    TaskQueueSharded::~TaskQueueSharded() {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void TaskQueueSharded::Delete() {
+        assert(!IsCurrent());
+
+        thread_should_quit_ = true;
+        NotifyWake();
+
+        delete this;
+    }
+
+    TaskQueueSharded::Shard& TaskQueueSharded::ShardOfCurrentThread() {
+        return shards_[ProducerIndex() % shard_count_];
+    }
+
+    void TaskQueueSharded::PostTask(std::unique_ptr<QueuedTask> task) {
+        auto& shard = ShardOfCurrentThread();
+        {
+            std::unique_lock<std::mutex> lock(shard.lock);
+            shard.tasks.push_back(std::move(task));
+            shard.size.store(shard.tasks.size());
+        }
+
+        // pairs with the check of the worker before it goes to sleep
+        if (idle_.load()) {
+            NotifyWake();
+        }
+    }
+
+    void TaskQueueSharded::PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+        DelayedEntryTimeout delayed_entry;
+        delayed_entry.next_fire_at = std::chrono::steady_clock::now() + delay;
+
+        {
+            std::unique_lock<std::mutex> lock(delayed_lock_);
+            delayed_entry.order = ++delayed_order_;
+            delayed_queue_[delayed_entry] = std::move(task);
+        }
+
+        NotifyWake();
+    }
+
+    void TaskQueueSharded::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+        PostDelayedTask(std::move(task), delay);
+    }
+
+    size_t TaskQueueSharded::PurgeTasksIf(const std::function<bool(const void* tag)>& match) {
+        // purged tasks are deleted out of the locks, their destruction may post tasks
+        std::vector<std::unique_ptr<QueuedTask>> purged;
+
+        auto purge = [&](std::deque<std::unique_ptr<QueuedTask>>& tasks) {
+            const size_t before = purged.size();
+            for (auto& task : tasks) {
+                if (task && match(task->tag())) {
+                    purged.push_back(std::move(task));
+                }
+            }
+            if (purged.size() != before) {
+                tasks.erase(std::remove(tasks.begin(), tasks.end(), nullptr), tasks.end());
+            }
+            return purged.size() - before;
+        };
+
+        for (size_t i = 0; i < shard_count_; ++i) {
+            auto& shard = shards_[i];
+            std::unique_lock<std::mutex> lock(shard.lock);
+            purge(shard.tasks);
+            shard.size.store(shard.tasks.size());
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(batch_lock_);
+            batch_size_ -= purge(batch_);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(delayed_lock_);
+            for (auto it = delayed_queue_.begin(); it != delayed_queue_.end();) {
+                if (match(it->second->tag())) {
+                    purged.push_back(std::move(it->second));
+                    it = delayed_queue_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        return purged.size();
+    }
+
+    size_t TaskQueueSharded::PendingTasks() const {
+        size_t count = batch_size_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < shard_count_; ++i) {
+            count += shards_[i].size.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    TaskQueueMemory TaskQueueSharded::MemoryUsage() const {
+        TaskQueueMemory usage;
+        auto add = [&usage](const std::deque<std::unique_ptr<QueuedTask>>& tasks) {
+            for (auto& task : tasks) {
+                if (task) {
+                    ++usage.pending_tasks;
+                    usage.pending_bytes += task->footprint();
+                }
+            }
+        };
+
+        for (size_t i = 0; i < shard_count_; ++i) {
+            auto& shard = shards_[i];
+            std::unique_lock<std::mutex> lock(shard.lock);
+            add(shard.tasks);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(batch_lock_);
+            add(batch_);
+        }
+
+        std::unique_lock<std::mutex> lock(delayed_lock_);
+        usage.delayed_tasks = delayed_queue_.size();
+        for (auto& entry : delayed_queue_) {
+            usage.delayed_bytes += entry.second->footprint();
+        }
+        return usage;
+    }
+
+    const std::string& TaskQueueSharded::Name() const {
+        return name_;
+    }
+
+    bool TaskQueueSharded::HasPendingTasks() const {
+        for (size_t i = 0; i < shard_count_; ++i) {
+            if (shards_[i].size.load() > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TaskQueueSharded::Run(std::unique_ptr<QueuedTask> task) {
+        QueuedTask* release_ptr = task.release();
+        if (release_ptr->run()) {
+            delete release_ptr;
+        }
+    }
+
+    std::chrono::milliseconds TaskQueueSharded::RunDueDelayedTasks() {
+        while (!thread_should_quit_) {
+            std::unique_ptr<QueuedTask> task;
+            {
+                std::unique_lock<std::mutex> lock(delayed_lock_);
+                if (delayed_queue_.empty()) {
+                    return std::chrono::milliseconds::max();
+                }
+                auto entry = delayed_queue_.begin();
+                auto now = std::chrono::steady_clock::now();
+                if (now < entry->first.next_fire_at) {
+                    return std::max(std::chrono::milliseconds(1),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(entry->first.next_fire_at - now));
+                }
+                task = std::move(entry->second);
+                delayed_queue_.erase(entry);
+            }
+            Run(std::move(task));
+        }
+        return std::chrono::milliseconds(0);
+    }
+
+    void TaskQueueSharded::RunBatch() {
+        while (!thread_should_quit_) {
+            std::unique_ptr<QueuedTask> task;
+            {
+                std::unique_lock<std::mutex> lock(batch_lock_);
+                if (batch_.empty()) {
+                    return;
+                }
+                task = std::move(batch_.front());
+                batch_.pop_front();
+            }
+            Run(std::move(task));
+            --batch_size_;
+        }
+    }
+
+    void TaskQueueSharded::ProcessTasks() {
+        size_t next_shard = 0;
+
+        while (!thread_should_quit_) {
+            auto sleep_time = RunDueDelayedTasks();
+
+            bool ran = false;
+            for (size_t i = 0; i < shard_count_ && !thread_should_quit_; ++i) {
+                auto& shard = shards_[(next_shard + i) % shard_count_];
+                if (shard.size.load(std::memory_order_relaxed) == 0) {
+                    continue;
+                }
+                {
+                    std::unique_lock<std::mutex> lock(shard.lock);
+                    std::unique_lock<std::mutex> batch_lock(batch_lock_);
+                    batch_.swap(shard.tasks);
+                    batch_size_ = batch_.size();
+                    shard.size.store(0);
+                }
+                RunBatch();
+                ran = true;
+            }
+            next_shard = (next_shard + 1) % shard_count_;
+
+            if (ran || thread_should_quit_) {
+                continue;
+            }
+
+            idle_.store(true);
+            if (!HasPendingTasks()) {
+                std::unique_lock<std::mutex> lock(notify_mutex_);
+                if (sleep_time == std::chrono::milliseconds::max()) {
+                    notify_cv_.wait(lock, [this]{ return notify_ready_; });
+                } else {
+                    notify_cv_.wait_for(lock, sleep_time, [this]{ return notify_ready_; });
+                }
+                notify_ready_ = false;
+            }
+            idle_.store(false);
+        }
+    }
+
+    void TaskQueueSharded::NotifyWake() {
+        {
+            std::lock_guard<std::mutex> lock(notify_mutex_);
+            notify_ready_ = true;
+        }
+        notify_cv_.notify_one();
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include "queued_task.hpp"
+#include "task_queue_base.hpp"
+#include "counting_allocator.hpp"
+
+namespace core {
+
+    // Task queue backend for queues fed by many producer threads.
+    //
+    // Each posting thread is bound to one of several inbox shards, each with its
+    // own lock, and the worker drains the shards round-robin, one whole shard at
+    // a time. Producers thus only contend with the producers sharing their shard
+    // and no global counter is updated per task.
+    //
+    // This relaxes the FIFO contract of TaskQueueBase to a per-producer FIFO:
+    // the tasks posted by a given thread run in the order they were posted, but
+    // tasks posted by different threads are not ordered. Delayed tasks run in
+    // order of due time, relative to each other only.
+    class TaskQueueSharded final : public TaskQueueBase {
+    public:
+        // |shards| of 0 uses one shard per hardware thread.
+        TaskQueueSharded(std::string_view queue_name, size_t shards = 0);
+        ~TaskQueueSharded() override;
+
+        void Delete() override;
+        void PostTask(std::unique_ptr<QueuedTask> task) override;
+        void PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
+        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
+        size_t PurgeTasksIf(const std::function<bool(const void* tag)>& match) override;
+        size_t PendingTasks() const override;
+        TaskQueueMemory MemoryUsage() const override;
+        const std::string& Name() const override;
+
+    private:
+        using OrderId = uint64_t;
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        struct DelayedEntryTimeout {
+            TimePoint next_fire_at;
+            OrderId order{};
+
+            bool operator<(const DelayedEntryTimeout& o) const {
+                return std::tie(next_fire_at, order) < std::tie(o.next_fire_at, o.order);
+            }
+        };
+
+        // nodes accounted in sigslot::memory_stats()
+        using DelayedQueue = std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>, std::less<DelayedEntryTimeout>,
+            sigslot::counting_allocator<std::pair<const DelayedEntryTimeout, std::unique_ptr<QueuedTask>>,
+                                        sigslot::detail::delayed_node_memory>>;
+
+        struct alignas(64) Shard {
+            std::mutex lock;
+            std::deque<std::unique_ptr<QueuedTask>> tasks;
+            std::atomic<size_t> size{0};
+        };
+
+        Shard& ShardOfCurrentThread();
+        bool HasPendingTasks() const;
+        std::chrono::milliseconds RunDueDelayedTasks();
+        void RunBatch();
+        void ProcessTasks();
+        void NotifyWake();
+        static void Run(std::unique_ptr<QueuedTask> task);
+
+        const size_t shard_count_;
+        std::unique_ptr<Shard[]> shards_;
+
+        // tasks taken from a shard, being run by the worker
+        mutable std::mutex batch_lock_;
+        std::deque<std::unique_ptr<QueuedTask>> batch_;
+        std::atomic<size_t> batch_size_{0};
+
+        mutable std::mutex delayed_lock_;
+        OrderId delayed_order_{0};
+        DelayedQueue delayed_queue_;
+
+        std::mutex notify_mutex_;
+        std::condition_variable notify_cv_;
+        bool notify_ready_{false};
+        std::atomic<bool> idle_{false};
+        std::atomic<bool> thread_should_quit_{false};
+
+        std::thread thread_;
+        std::string name_;
+    };
+}
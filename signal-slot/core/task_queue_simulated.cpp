@@ -0,0 +1,224 @@
+#include "task_queue_simulated.hpp"
+#include <assert.h>
+#include <algorithm>
+
+namespace core {
+
+    SimulatedClock::SimulatedClock(TimePoint start)
+    : now_(start.time_since_epoch().count()) {}
+
+    SimulatedClock::~SimulatedClock() {
+        assert(queues_.empty() && "the clock must outlive its queues");
+    }
+
+    SimulatedClock::TimePoint SimulatedClock::Now() const {
+        return TimePoint(TimePoint::duration(now_.load(std::memory_order_acquire)));
+    }
+
+    void SimulatedClock::AdvanceTime(std::chrono::milliseconds delta) {
+        const auto target = Now() + delta;
+
+        while (true) {
+            RunReady();
+
+            std::optional<TimePoint> next;
+            {
+                std::lock_guard<std::mutex> lock(queues_lock_);
+                for (auto* queue : queues_) {
+                    auto deadline = queue->NextDeadline();
+                    if (deadline && (!next || *deadline < *next)) {
+                        next = deadline;
+                    }
+                }
+            }
+            if (!next || *next > target) {
+                break;
+            }
+            now_.store(std::max(*next, Now()).time_since_epoch().count(), std::memory_order_release);
+        }
+
+        now_.store(target.time_since_epoch().count(), std::memory_order_release);
+        RunReady();
+    }
+
+    void SimulatedClock::Attach(TaskQueueSimulated* queue) {
+        std::lock_guard<std::mutex> lock(queues_lock_);
+        queues_.push_back(queue);
+    }
+
+    void SimulatedClock::Detach(TaskQueueSimulated* queue) {
+        std::lock_guard<std::mutex> lock(queues_lock_);
+        queues_.erase(std::remove(queues_.begin(), queues_.end(), queue), queues_.end());
+    }
+
+    bool SimulatedClock::RunReady() {
+        bool any = false;
+        for (bool ran = true; ran;) {
+            ran = false;
+            // queues may be created or deleted by the tasks, the list is read
+            // again for each queue
+            for (size_t i = 0;; ++i) {
+                TaskQueueSimulated* queue;
+                {
+                    std::lock_guard<std::mutex> lock(queues_lock_);
+                    if (i >= queues_.size()) {
+                        break;
+                    }
+                    queue = queues_[i];
+                }
+                while (queue->RunNext(Now())) {
+                    ran = any = true;
+                }
+            }
+        }
+        return any;
+    }
+
+    TaskQueueSimulated::TaskQueueSimulated(std::string_view queue_name, SimulatedClock& clock)
+    : clock_(clock), name_(queue_name) {
+        clock_.Attach(this);
+    }
+
+    TaskQueueSimulated::~TaskQueueSimulated() = default;
+
+    void TaskQueueSimulated::Delete() {
+        assert(!IsCurrent());
+        clock_.Detach(this);
+
+        // pending tasks are deleted without being run
+        decltype(pending_queue_) pending;
+        decltype(delayed_queue_) delayed;
+        {
+            std::lock_guard<std::mutex> lock(pending_lock_);
+            pending.swap(pending_queue_);
+            delayed.swap(delayed_queue_);
+        }
+
+        delete this;
+    }
+
+    void TaskQueueSimulated::PostTask(std::unique_ptr<QueuedTask> task) {
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        pending_queue_.push_back(std::make_pair(++posting_order_, std::move(task)));
+    }
+
+    void TaskQueueSimulated::PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+        DelayedEntryTimeout delayed_entry;
+        delayed_entry.next_fire_at = clock_.Now() + delay;
+
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        delayed_entry.order = ++posting_order_;
+        delayed_queue_[delayed_entry] = std::move(task);
+    }
+
+    void TaskQueueSimulated::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+        PostDelayedTask(std::move(task), delay);
+    }
+
+    size_t TaskQueueSimulated::PurgeTasksIf(const std::function<bool(const void* tag)>& match) {
+        // purged tasks are deleted out of the lock, their destruction may post tasks
+        std::vector<std::unique_ptr<QueuedTask>> purged;
+
+        {
+            std::lock_guard<std::mutex> lock(pending_lock_);
+
+            for (auto& entry : pending_queue_) {
+                if (match(entry.second->tag())) {
+                    purged.push_back(std::move(entry.second));
+                }
+            }
+            if (!purged.empty()) {
+                pending_queue_.erase(std::remove_if(pending_queue_.begin(), pending_queue_.end(),
+                    [](const auto& entry) { return !entry.second; }), pending_queue_.end());
+            }
+
+            for (auto it = delayed_queue_.begin(); it != delayed_queue_.end();) {
+                if (match(it->second->tag())) {
+                    purged.push_back(std::move(it->second));
+                    it = delayed_queue_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        return purged.size();
+    }
+
+    size_t TaskQueueSimulated::PendingTasks() const {
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        const auto now = clock_.Now();
+        size_t due = 0;
+        for (auto& entry : delayed_queue_) {
+            if (entry.first.next_fire_at > now) {
+                break;
+            }
+            ++due;
+        }
+        return pending_queue_.size() + due + (running_ ? 1 : 0);
+    }
+
+    Clock& TaskQueueSimulated::GetClock() const {
+        return clock_;
+    }
+
+    TaskQueueMemory TaskQueueSimulated::MemoryUsage() const {
+        TaskQueueMemory usage;
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        usage.pending_tasks = pending_queue_.size();
+        for (auto& entry : pending_queue_) {
+            usage.pending_bytes += entry.second->footprint();
+        }
+        usage.delayed_tasks = delayed_queue_.size();
+        for (auto& entry : delayed_queue_) {
+            usage.delayed_bytes += entry.second->footprint();
+        }
+        return usage;
+    }
+
+    const std::string& TaskQueueSimulated::Name() const {
+        return name_;
+    }
+
+    bool TaskQueueSimulated::RunNext(TimePoint now) {
+        std::unique_ptr<QueuedTask> task;
+        {
+            std::lock_guard<std::mutex> lock(pending_lock_);
+
+            // same ordering as TaskQueueStdlib: a due delayed task runs before the
+            // tasks posted after it
+            auto delayed = delayed_queue_.begin();
+            const bool delayed_due = delayed != delayed_queue_.end() && delayed->first.next_fire_at <= now;
+            if (!pending_queue_.empty() && (!delayed_due || pending_queue_.front().first < delayed->first.order)) {
+                task = std::move(pending_queue_.front().second);
+                pending_queue_.pop_front();
+            } else if (delayed_due) {
+                task = std::move(delayed->second);
+                delayed_queue_.erase(delayed);
+            } else {
+                return false;
+            }
+            running_ = true;
+        }
+
+        {
+            CurrentTaskQueueSetter setCurrent(this);
+            QueuedTask* release_ptr = task.release();
+            if (release_ptr->run()) {
+                delete release_ptr;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        running_ = false;
+        return true;
+    }
+
+    std::optional<TaskQueueSimulated::TimePoint> TaskQueueSimulated::NextDeadline() const {
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        if (delayed_queue_.empty()) {
+            return std::nullopt;
+        }
+        return delayed_queue_.begin()->first.next_fire_at;
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <optional>
+#include <tuple>
+#include "queued_task.hpp"
+#include "task_queue_base.hpp"
+#include "counting_allocator.hpp"
+#include "clock.hpp"
+
+namespace core {
+
+    class TaskQueueSimulated;
+
+    // A virtual clock driving TaskQueueSimulated queues. The time only moves
+    // forward when AdvanceTime is called, which runs the tasks due by then on
+    // the calling thread, in order of due time.
+    class SimulatedClock final : public Clock {
+    public:
+        explicit SimulatedClock(TimePoint start = TimePoint{});
+        ~SimulatedClock() override;
+
+        TimePoint Now() const override;
+
+        // Moves the time forward by |delta|, stopping at each due time of a
+        // delayed task to run it, and runs every task ready at the new time.
+        // Tasks posted while running are run as well if they are due.
+        void AdvanceTime(std::chrono::milliseconds delta);
+
+        // Runs the tasks ready at the current time, see AdvanceTime.
+        void RunUntilIdle() { AdvanceTime(std::chrono::milliseconds(0)); }
+
+    private:
+        friend class TaskQueueSimulated;
+
+        void Attach(TaskQueueSimulated* queue);
+        void Detach(TaskQueueSimulated* queue);
+        bool RunReady();
+
+        SimulatedClock& operator=(const SimulatedClock&) = delete;
+        SimulatedClock(const SimulatedClock&) = delete;
+
+    private:
+        std::atomic<TimePoint::rep> now_;
+        std::mutex queues_lock_;
+        std::vector<TaskQueueSimulated*> queues_;
+    };
+
+    // Task queue backend without a thread, for deterministic tests of timing
+    // behaviours. Tasks only run from SimulatedClock::AdvanceTime() or
+    // RunUntilIdle(), on the thread calling it, and delayed tasks are due
+    // according to the simulated clock, so that waiting for them takes no real
+    // time. Tasks may be posted from any thread, the clock must be driven by a
+    // single one. The clock must outlive its queues.
+    class TaskQueueSimulated final : public TaskQueueBase {
+    public:
+        TaskQueueSimulated(std::string_view queue_name, SimulatedClock& clock);
+        ~TaskQueueSimulated() override;
+
+        void Delete() override;
+        void PostTask(std::unique_ptr<QueuedTask> task) override;
+        void PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
+        void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
+        size_t PurgeTasksIf(const std::function<bool(const void* tag)>& match) override;
+        size_t PendingTasks() const override;
+        TaskQueueMemory MemoryUsage() const override;
+        Clock& GetClock() const override;
+        const std::string& Name() const override;
+
+    private:
+        friend class SimulatedClock;
+
+        using OrderId = uint64_t;
+        using TimePoint = Clock::TimePoint;
+
+        struct DelayedEntryTimeout {
+            TimePoint next_fire_at;
+            OrderId order{};
+
+            bool operator<(const DelayedEntryTimeout& o) const {
+                return std::tie(next_fire_at, order) < std::tie(o.next_fire_at, o.order);
+            }
+        };
+
+        // nodes accounted in sigslot::memory_stats()
+        using DelayedQueue = std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>, std::less<DelayedEntryTimeout>,
+            sigslot::counting_allocator<std::pair<const DelayedEntryTimeout, std::unique_ptr<QueuedTask>>,
+                                        sigslot::detail::delayed_node_memory>>;
+
+        // Runs the next task ready at |now|, returns false if there is none.
+        bool RunNext(TimePoint now);
+
+        // Due time of the first delayed task, if any.
+        std::optional<TimePoint> NextDeadline() const;
+
+        SimulatedClock& clock_;
+
+        mutable std::mutex pending_lock_;
+        OrderId posting_order_{0};
+        std::deque<std::pair<OrderId, std::unique_ptr<QueuedTask>>> pending_queue_;
+        DelayedQueue delayed_queue_;
+        bool running_{false};
+
+        std::string name_;
+    };
+}
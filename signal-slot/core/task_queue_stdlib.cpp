@@ -3,7 +3,14 @@
 
 namespace core {
 
-    TaskQueueStdlib::TaskQueueStdlib(std::string_view queue_name)
+    namespace {
+
+        std::atomic<bool> g_profile_locks{false};
+
+    }  // namespace
+
+    template <typename Mutex>
+    BasicTaskQueueStdlib<Mutex>::BasicTaskQueueStdlib(std::string_view queue_name)
     : name_(queue_name) {
         thread_ = std::thread([this]{
             CurrentTaskQueueSetter setCurrent(this);
@@ -21,17 +28,19 @@ namespace core {
         start_cv_.wait(lock, [this]{ return started_.load(); });
     }
 
-    TaskQueueStdlib::~TaskQueueStdlib() {
+    template <typename Mutex>
+    BasicTaskQueueStdlib<Mutex>::~BasicTaskQueueStdlib() {
         if (thread_.joinable()) {
             thread_.join();
         }
     }
 
-    void TaskQueueStdlib::Delete() {
+    template <typename Mutex>
+    void BasicTaskQueueStdlib<Mutex>::Delete() {
         assert(!IsCurrent());
 
         {
-            std::unique_lock<std::mutex> lock(pending_lock_);
+            std::unique_lock<Lock> lock(pending_lock_);
             thread_should_quit_ = true;
         }
 
@@ -40,21 +49,24 @@ namespace core {
         delete this;
     }
 
-    void TaskQueueStdlib::PostTask(std::unique_ptr<QueuedTask> task) {
+    template <typename Mutex>
+    void BasicTaskQueueStdlib<Mutex>::PostTask(std::unique_ptr<QueuedTask> task) {
         {
-            std::unique_lock<std::mutex> lock(pending_lock_);
-            pending_queue_.push(std::make_pair(++thread_posting_order_, std::move(task)));
+            std::unique_lock<Lock> lock(pending_lock_);
+            pending_queue_.push_back(std::make_pair(++thread_posting_order_, std::move(task)));
+            ++pending_count_;
         }
 
         NotifyWake();
     }
 
-    void TaskQueueStdlib::PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+    template <typename Mutex>
+    void BasicTaskQueueStdlib<Mutex>::PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
         DelayedEntryTimeout delayed_entry;
         delayed_entry.next_fire_at = std::chrono::steady_clock::now() + delay;
 
         {
-            std::unique_lock<std::mutex> lock(pending_lock_);
+            std::unique_lock<Lock> lock(pending_lock_);
             delayed_entry.order = ++thread_posting_order_;
             delayed_queue_[delayed_entry] = std::move(task);
         }
@@ -62,20 +74,103 @@ namespace core {
         NotifyWake();
     }
 
-    void TaskQueueStdlib::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
+    template <typename Mutex>
+    void BasicTaskQueueStdlib<Mutex>::PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) {
         PostDelayedTask(std::move(task), delay);
     }
 
-    const std::string& TaskQueueStdlib::Name() const {
+    template <typename Mutex>
+    size_t BasicTaskQueueStdlib<Mutex>::PurgeTasksIf(const std::function<bool(const void* tag)>& match) {
+        // purged tasks are deleted out of the lock, their destruction may post tasks
+        std::vector<std::unique_ptr<QueuedTask>> purged;
+
+        {
+            std::unique_lock<Lock> lock(pending_lock_);
+
+            for (auto& entry : pending_queue_) {
+                if (match(entry.second->tag())) {
+                    purged.push_back(std::move(entry.second));
+                }
+            }
+            if (!purged.empty()) {
+                pending_queue_.erase(std::remove_if(pending_queue_.begin(), pending_queue_.end(),
+                    [](const auto& entry) { return !entry.second; }), pending_queue_.end());
+                pending_count_ -= purged.size();
+            }
+
+            for (auto it = delayed_queue_.begin(); it != delayed_queue_.end();) {
+                if (match(it->second->tag())) {
+                    purged.push_back(std::move(it->second));
+                    it = delayed_queue_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        return purged.size();
+    }
+
+    template <typename Mutex>
+    size_t BasicTaskQueueStdlib<Mutex>::PendingTasks() const {
+        return pending_count_.load(std::memory_order_relaxed);
+    }
+
+    template <typename Mutex>
+    TaskQueueMemory BasicTaskQueueStdlib<Mutex>::MemoryUsage() const {
+        TaskQueueMemory usage;
+        std::unique_lock<Lock> lock(pending_lock_);
+        usage.pending_tasks = pending_queue_.size();
+        for (auto& entry : pending_queue_) {
+            usage.pending_bytes += entry.second->footprint();
+        }
+        usage.delayed_tasks = delayed_queue_.size();
+        for (auto& entry : delayed_queue_) {
+            usage.delayed_bytes += entry.second->footprint();
+        }
+        return usage;
+    }
+
+    template <typename Mutex>
+    const std::string& BasicTaskQueueStdlib<Mutex>::Name() const {
         return name_;
     }
 
-    TaskQueueStdlib::NextTask TaskQueueStdlib::GetNextTask() {
+    template <typename Mutex>
+    void BasicTaskQueueStdlib<Mutex>::ProfileLocks(bool enable) {
+        g_profile_locks.store(enable, std::memory_order_relaxed);
+    }
+
+    template <typename Mutex>
+    bool BasicTaskQueueStdlib<Mutex>::LocksProfiled() {
+        return g_profile_locks.load(std::memory_order_relaxed);
+    }
+
+    template <typename Mutex>
+    sigslot::lock_stats BasicTaskQueueStdlib<Mutex>::PendingLockStats() const {
+        if constexpr (std::is_same_v<Mutex, std::mutex>) {
+            return {};
+        } else {
+            return pending_lock_.stats();
+        }
+    }
+
+    template <typename Mutex>
+    sigslot::lock_stats BasicTaskQueueStdlib<Mutex>::NotifyLockStats() const {
+        if constexpr (std::is_same_v<Mutex, std::mutex>) {
+            return {};
+        } else {
+            return notify_mutex_.stats();
+        }
+    }
+
+    template <typename Mutex>
+    typename BasicTaskQueueStdlib<Mutex>::NextTask BasicTaskQueueStdlib<Mutex>::GetNextTask() {
         NextTask result;
         
         auto now = std::chrono::steady_clock::now();
 
-        std::unique_lock<std::mutex> lock(pending_lock_);
+        std::unique_lock<Lock> lock(pending_lock_);
 
         if (thread_should_quit_) {
             result.final_task = true;
@@ -94,11 +189,13 @@ namespace core {
                     auto& entry_run = entry.second;
                     if (entry_order < delay_info.order) {
                         result.run_task = std::move(entry_run);
-                        pending_queue_.pop();
+                        pending_queue_.pop_front();
                         return result;
                     }
                 }
 
+                // due delayed tasks count as pending while they run
+                ++pending_count_;
                 result.run_task = std::move(delay_run);
                 delayed_queue_.erase(delayed_entry);
                 return result;
@@ -111,13 +208,14 @@ namespace core {
         if (pending_queue_.size() > 0) {
             auto& entry = pending_queue_.front();
             result.run_task = std::move(entry.second);
-            pending_queue_.pop();
+            pending_queue_.pop_front();
         }
 
         return result;
     }
 
-    void TaskQueueStdlib::ProcessTasks() {
+    template <typename Mutex>
+    void BasicTaskQueueStdlib<Mutex>::ProcessTasks() {
         while (true) {
             auto task = GetNextTask();
 
@@ -129,11 +227,12 @@ namespace core {
                 if (release_ptr->run()) {
                     delete release_ptr;
                 }
+                --pending_count_;
                 continue;
             }
 
             if (task.sleep_time.count() > 0) {
-                std::unique_lock<std::mutex> lock(notify_mutex_);
+                std::unique_lock<Lock> lock(notify_mutex_);
                 notify_cv_.wait_for(lock, task.sleep_time, 
                     [this]{ return notify_ready_.load(); });
                 notify_ready_ = false;
@@ -141,11 +240,15 @@ namespace core {
         }
     }
 
-    void TaskQueueStdlib::NotifyWake() {
+    template <typename Mutex>
+    void BasicTaskQueueStdlib<Mutex>::NotifyWake() {
         {
-            std::lock_guard<std::mutex> lock(notify_mutex_);
+            std::lock_guard<Lock> lock(notify_mutex_);
             notify_ready_ = true;
         }
         notify_cv_.notify_one();
     }
+
+    template class BasicTaskQueueStdlib<std::mutex>;
+    template class BasicTaskQueueStdlib<sigslot::instrumented_lock<std::mutex>>;
 }
@@ -4,29 +4,54 @@
 #include <algorithm>
 #include <map>
 #include <memory>
-#include <queue>
+#include <deque>
+#include <vector>
 #include <utility>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
 #include <atomic>
+#include <type_traits>
 #include "queued_task.hpp"
 #include "task_queue_base.hpp"
+#include "instrumented_lock.hpp"
+#include "counting_allocator.hpp"
 
 namespace core {
-    class TaskQueueStdlib final : public TaskQueueBase {
+    // Runs the tasks on a thread of its own. Mutex guards the pending tasks and
+    // the wake up of the thread: std::mutex with a std::condition_variable for
+    // TaskQueueStdlib, sigslot::instrumented_lock for ProfiledTaskQueueStdlib.
+    template <typename Mutex>
+    class BasicTaskQueueStdlib final : public TaskQueueBase {
     public:
-        TaskQueueStdlib(std::string_view queue_name);
-        ~TaskQueueStdlib() override;
+        BasicTaskQueueStdlib(std::string_view queue_name);
+        ~BasicTaskQueueStdlib() override;
 
         void Delete() override;
         void PostTask(std::unique_ptr<QueuedTask> task) override;
         void PostDelayedTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
         void PostDelayedHighPrecisionTask(std::unique_ptr<QueuedTask> task, std::chrono::milliseconds delay) override;
+        size_t PurgeTasksIf(const std::function<bool(const void* tag)>& match) override;
+        size_t PendingTasks() const override;
+        TaskQueueMemory MemoryUsage() const override;
         const std::string& Name() const override;
 
+        // Makes TaskQueue::Create() return a ProfiledTaskQueueStdlib, profiling
+        // the contention of pending_lock_ and notify_mutex_, for the queues
+        // created afterwards. Off by default.
+        static void ProfileLocks(bool enable);
+        static bool LocksProfiled();
+
+        // Counters of the locks of this queue, empty unless profiled.
+        sigslot::lock_stats PendingLockStats() const;
+        sigslot::lock_stats NotifyLockStats() const;
+
     private:
+        using Lock = Mutex;
+        using ConditionVariable = std::conditional_t<std::is_same_v<Mutex, std::mutex>,
+            std::condition_variable, std::condition_variable_any>;
+
         using OrderId = uint64_t;
         using TimePoint = std::chrono::steady_clock::time_point;
 
@@ -39,6 +64,11 @@ namespace core {
             }
         };
 
+        // nodes accounted in sigslot::memory_stats()
+        using DelayedQueue = std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>, std::less<DelayedEntryTimeout>,
+            sigslot::counting_allocator<std::pair<const DelayedEntryTimeout, std::unique_ptr<QueuedTask>>,
+                                        sigslot::detail::delayed_node_memory>>;
+
         struct NextTask {
             bool final_task{false};
             std::unique_ptr<QueuedTask> run_task;
@@ -49,15 +79,17 @@ namespace core {
         void ProcessTasks();
         void NotifyWake();
 
-        std::mutex notify_mutex_;
-        std::condition_variable notify_cv_;
+        Lock notify_mutex_;
+        ConditionVariable notify_cv_;
         std::atomic<bool> notify_ready_{false};
 
-        std::mutex pending_lock_;
+        mutable Lock pending_lock_;
         std::atomic<bool> thread_should_quit_{false};
         std::atomic<OrderId> thread_posting_order_{0};
-        std::queue<std::pair<OrderId, std::unique_ptr<QueuedTask>>> pending_queue_;
-        std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>> delayed_queue_;
+        std::deque<std::pair<OrderId, std::unique_ptr<QueuedTask>>> pending_queue_;
+        DelayedQueue delayed_queue_;
+        // tasks in pending_queue_ plus the one running, readable without the lock
+        std::atomic<size_t> pending_count_{0};
         
         std::mutex start_mutex_;
         std::condition_variable start_cv_;
@@ -66,5 +98,11 @@ namespace core {
         std::thread thread_;
         std::string name_;
     };
+
+    using TaskQueueStdlib = BasicTaskQueueStdlib<std::mutex>;
+    using ProfiledTaskQueueStdlib = BasicTaskQueueStdlib<sigslot::instrumented_lock<std::mutex>>;
+
+    extern template class BasicTaskQueueStdlib<std::mutex>;
+    extern template class BasicTaskQueueStdlib<sigslot::instrumented_lock<std::mutex>>;
 }
 
@@ -0,0 +1,158 @@
+#include "unix_socket.hpp"
+#include <string>
+
+#if defined(CORE_POSIX)
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#endif
+
+namespace core {
+
+#if defined(CORE_POSIX)
+
+    namespace {
+
+        bool MakeAddress(std::string_view path, sockaddr_un& addr) {
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(addr.sun_path)) {
+                return false;
+            }
+            std::memcpy(addr.sun_path, path.data(), path.size());
+            return true;
+        }
+
+    }  // namespace
+
+    int UnixListen(std::string_view path) {
+        sockaddr_un addr;
+        if (!MakeAddress(path, addr)) {
+            return -1;
+        }
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        unlink(addr.sun_path);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    int UnixAccept(int listen_fd) {
+        int fd;
+        do {
+            fd = accept(listen_fd, nullptr, nullptr);
+        } while (fd < 0 && errno == EINTR);
+        return fd;
+    }
+
+    int UnixConnect(std::string_view path) {
+        sockaddr_un addr;
+        if (!MakeAddress(path, addr)) {
+            return -1;
+        }
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool UnixSocketPair(int fds[2]) {
+        return socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0;
+    }
+
+    bool SetNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    void CloseSocket(int fd) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool WriteVectored(int fd, const IoSlice* slices, size_t count) {
+#if defined(MSG_NOSIGNAL)
+        constexpr int kFlags = MSG_NOSIGNAL;
+#else
+        constexpr int kFlags = 0;
+#endif
+        std::vector<iovec> iov(count);
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = const_cast<void*>(slices[i].data);
+            iov[i].iov_len = slices[i].size;
+        }
+
+        size_t first = 0;
+        while (first < count) {
+            if (iov[first].iov_len == 0) {
+                ++first;
+                continue;
+            }
+            msghdr msg{};
+            msg.msg_iov = &iov[first];
+            msg.msg_iovlen = std::min<size_t>(count - first, IOV_MAX);
+            ssize_t written = sendmsg(fd, &msg, kFlags);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            // skip what was written, resuming within a partially written slice
+            size_t left = static_cast<size_t>(written);
+            while (first < count && left >= iov[first].iov_len) {
+                left -= iov[first].iov_len;
+                ++first;
+            }
+            if (first < count) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                iov[first].iov_len -= left;
+            }
+        }
+        return true;
+    }
+
+    long ReadSome(int fd, void* buffer, size_t size) {
+        for (;;) {
+            ssize_t n = read(fd, buffer, size);
+            if (n >= 0) {
+                return static_cast<long>(n);
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? kReadWouldBlock : kReadError;
+        }
+    }
+
+#else
+
+    int UnixListen(std::string_view) { return -1; }
+    int UnixAccept(int) { return -1; }
+    int UnixConnect(std::string_view) { return -1; }
+    bool UnixSocketPair(int[2]) { return false; }
+    bool SetNonBlocking(int) { return false; }
+    void CloseSocket(int) {}
+    bool WriteVectored(int, const IoSlice*, size_t) { return false; }
+    long ReadSome(int, void*, size_t) { return kReadError; }
+
+#endif
+
+}
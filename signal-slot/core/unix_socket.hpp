@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace core {
+
+    // Thin helpers over Unix domain stream sockets, returning -1 or false on
+    // failure. Only available on POSIX systems, where CORE_POSIX is defined.
+
+    // Binds and listens on |path|, replacing a stale socket file.
+    int UnixListen(std::string_view path);
+
+    // Accepts a connection on a listening socket, blocking.
+    int UnixAccept(int listen_fd);
+
+    int UnixConnect(std::string_view path);
+
+    // Creates a pair of connected sockets, fds[0] and fds[1].
+    bool UnixSocketPair(int fds[2]);
+
+    bool SetNonBlocking(int fd);
+
+    void CloseSocket(int fd);
+
+    struct IoSlice {
+        const void* data;
+        size_t size;
+    };
+
+    // Writes all the slices with vectored writes, blocking until done. Returns
+    // false if the peer went away or on error. Never raises SIGPIPE.
+    bool WriteVectored(int fd, const IoSlice* slices, size_t count);
+
+    enum : long { kReadWouldBlock = -1, kReadError = -2 };
+
+    // Reads available bytes, returns their number, 0 at end of stream,
+    // kReadWouldBlock on a non-blocking socket without data, or kReadError.
+    long ReadSome(int fd, void* buffer, size_t size);
+
+}
@@ -1,6 +1,17 @@
 #pragma once
 
 #include "./core/signal.hpp"
+#include "./core/keyed_signal.hpp"
+#include "./core/event_bus.hpp"
+#include "./core/codec.hpp"
+#include "./core/broadcast.hpp"
+#include "./core/shm_signal.hpp"
+#include "./core/remote_signal.hpp"
+#include "./core/journal.hpp"
+#include "./core/connection_graph.hpp"
+#include "./core/slot_profiler.hpp"
+#include "./core/instrumented_lock.hpp"
+#include "./core/memory_stats.hpp"
 #include "./signal-slot/core/task_queue.hpp"
 
 // Macro for signal declaration
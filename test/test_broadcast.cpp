@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "./signal-slot/core/task_queue_manager.hpp"
+
+class BroadcastTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TQMgr->create({"consumer1", "consumer2", "consumer3"});
+    }
+
+    void TearDown() override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    template <typename Pred>
+    static void waitFor(Pred pred) {
+        for (int i = 0; i < 200 && !pred(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+};
+
+// Test every consumer receives every event, in order
+TEST_F(BroadcastTest, FanOutInOrder) {
+    sigslot::broadcast_channel<int, std::string> channel(64);
+    sigslot::signal<int, std::string> sig;
+    channel.attach(sig);
+
+    const char *names[] = {"consumer1", "consumer2", "consumer3"};
+    std::vector<int> received[3];
+    std::atomic<int> calls{0};
+    for (int c = 0; c < 3; ++c) {
+        channel.subscribe(TQ(names[c]), [&received, &calls, c](int v, const std::string& s) {
+            EXPECT_EQ(s, std::to_string(v));
+            received[c].push_back(v);
+            ++calls;
+        });
+    }
+    EXPECT_EQ(channel.consumer_count(), 3u);
+
+    for (int i = 0; i < 5000; ++i) {
+        sig(i, std::to_string(i));
+    }
+    waitFor([&calls]() { return calls == 15000; });
+
+    ASSERT_EQ(calls, 15000);
+    for (auto& seq : received) {
+        ASSERT_EQ(seq.size(), 5000u);
+        for (int i = 0; i < 5000; ++i) {
+            ASSERT_EQ(seq[i], i);
+        }
+    }
+    EXPECT_EQ(channel.backlog(), 0u);
+}
+
+// Test attached signals may be emitted from several threads
+TEST_F(BroadcastTest, AttachSeveralEmitters) {
+    sigslot::broadcast_channel<int, int> channel(256);
+    sigslot::signal<int, int> sig;
+    sigslot::signal<int, int> other;
+    channel.attach(sig);
+    channel.attach(other);
+
+    std::vector<std::vector<int>> received(4);
+    std::atomic<int> calls{0};
+    channel.subscribe(TQ("consumer1"), [&received, &calls](int emitter, int v) {
+        received[emitter].push_back(v);
+        ++calls;
+    });
+
+    std::vector<std::thread> emitters;
+    for (int e = 0; e < 4; ++e) {
+        emitters.emplace_back([&sig, &other, e]() {
+            for (int i = 0; i < 500; ++i) {
+                (e % 2 ? other : sig)(e, i);
+            }
+        });
+    }
+    for (auto& t : emitters) {
+        t.join();
+    }
+    waitFor([&calls]() { return calls == 2000; });
+
+    ASSERT_EQ(calls, 2000);
+    for (auto& seq : received) {
+        ASSERT_EQ(seq.size(), 500u);
+        for (int i = 0; i < 500; ++i) {
+            ASSERT_EQ(seq[i], i);
+        }
+    }
+}
+
+// Test the slowest consumer applies backpressure
+TEST_F(BroadcastTest, Backpressure) {
+    sigslot::broadcast_channel<int> channel(4);
+    std::atomic<int> fast{0}, slow{0};
+
+    channel.subscribe(TQ("consumer1"), [&fast](int) { ++fast; });
+    auto id = channel.subscribe(TQ("consumer2"), [&slow](int) { ++slow; });
+
+    std::promise<void> gate;
+    auto blocked = gate.get_future().share();
+    TQ("consumer2")->PostTask([blocked]() { blocked.wait(); });
+
+    int published = 0;
+    while (channel.try_publish(published)) {
+        ++published;
+    }
+    EXPECT_EQ(published, 4);
+    EXPECT_EQ(channel.backlog(), 4u);
+
+    gate.set_value();
+    waitFor([&]() { return channel.backlog() == 0; });
+    EXPECT_TRUE(channel.try_publish(published));
+
+    // removed consumers no longer hold the producer back
+    waitFor([&slow]() { return slow == 5; });
+    EXPECT_TRUE(channel.unsubscribe(id));
+    for (int i = 0; i < 100; ++i) {
+        channel.publish(i);
+    }
+    waitFor([&fast]() { return fast == 105; });
+    EXPECT_EQ(fast, 105);
+    EXPECT_EQ(slow, 5);
+}
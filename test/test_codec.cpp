@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+
+namespace {
+
+struct Point {
+    int x;
+    int y;
+};
+
+// user type with its own encoding, a name and a list of points
+struct Shape {
+    std::string name;
+    std::vector<Point> points;
+};
+
+} // namespace
+
+template <>
+struct sigslot::codec_traits<Shape> {
+    using name_codec = codec_traits<std::string>;
+    using points_codec = codec_traits<std::vector<Point>>;
+
+    struct view_type {
+        std::string_view name;
+        sigslot::packed_view<Point> points;
+    };
+
+    static std::size_t size(const Shape& s) noexcept {
+        return name_codec::size(s.name) + points_codec::size(s.points);
+    }
+
+    static unsigned char* encode(unsigned char *p, const Shape& s) noexcept {
+        return points_codec::encode(name_codec::encode(p, s.name), s.points);
+    }
+
+    static bool decode(const unsigned char *&p, const unsigned char *end, view_type& v) {
+        return name_codec::decode(p, end, v.name) && points_codec::decode(p, end, v.points);
+    }
+
+    static Shape load(const view_type& v) {
+        return Shape{std::string(v.name), v.points.to_vector()};
+    }
+};
+
+// Test fixed size packs are copied bytewise
+TEST(CodecTest, FixedSize) {
+    using codec = sigslot::codec<int, const Point&, double>;
+    static_assert(codec::is_fixed_size);
+    static_assert(codec::fixed_size() == sizeof(int) + sizeof(Point) + sizeof(double));
+    static_assert(!sigslot::codec<int, std::string>::is_fixed_size);
+    static_assert(codec::signature() != sigslot::codec<double, Point, int>::signature());
+
+    std::array<unsigned char, 64> buffer;
+    ASSERT_EQ(codec::encode(buffer.data(), buffer.size(), 7, Point{1, 2}, 0.5), codec::fixed_size());
+    EXPECT_EQ(codec::encode(buffer.data(), codec::fixed_size() - 1, 7, Point{1, 2}, 0.5), 0u);
+
+    int calls = 0;
+    EXPECT_TRUE(codec::decode(buffer.data(), codec::fixed_size(), [&](int i, const Point& p, double d) {
+        EXPECT_EQ(i, 7);
+        EXPECT_EQ(p.x, 1);
+        EXPECT_EQ(p.y, 2);
+        EXPECT_DOUBLE_EQ(d, 0.5);
+        ++calls;
+    }));
+    EXPECT_EQ(calls, 1);
+}
+
+// Test strings and vectors decode as views into the buffer
+TEST(CodecTest, ZeroCopyViews) {
+    using codec = sigslot::codec<std::string, std::vector<Point>, std::vector<std::string>>;
+    const std::string text = "hello codec";
+    const std::vector<Point> points{{1, 2}, {3, 4}, {5, 6}};
+    const std::vector<std::string> words{"a", "", "bcd"};
+
+    std::vector<unsigned char> buffer(codec::size(text, points, words));
+    ASSERT_EQ(codec::encode(buffer.data(), buffer.size(), text, points, words), buffer.size());
+
+    int calls = 0;
+    EXPECT_TRUE(codec::decode_views(buffer.data(), buffer.size(),
+        [&](std::string_view s, sigslot::packed_view<Point> v, const std::vector<std::string>& w) {
+            EXPECT_EQ(s, text);
+            EXPECT_GE(reinterpret_cast<const unsigned char*>(s.data()), buffer.data());
+            EXPECT_LT(reinterpret_cast<const unsigned char*>(s.data()), buffer.data() + buffer.size());
+            ASSERT_EQ(v.size(), 3u);
+            EXPECT_EQ(v[2].y, 6);
+            int sum = 0;
+            for (Point p : v) {
+                sum += p.x;
+            }
+            EXPECT_EQ(sum, 9);
+            EXPECT_EQ(w, words);
+            ++calls;
+        }));
+
+    EXPECT_TRUE(codec::decode(buffer.data(), buffer.size(),
+        [&](const std::string& s, const std::vector<Point>& v, const std::vector<std::string>& w) {
+            EXPECT_EQ(s, text);
+            ASSERT_EQ(v.size(), 3u);
+            EXPECT_EQ(v[1].x, 3);
+            EXPECT_EQ(w.size(), 3u);
+            ++calls;
+        }));
+    EXPECT_EQ(calls, 2);
+}
+
+// Test truncated or oversized input is rejected without reading past the end
+TEST(CodecTest, Malformed) {
+    using codec = sigslot::codec<std::string, int>;
+    std::vector<unsigned char> buffer(codec::size("abc", 1));
+    codec::encode(buffer.data(), std::string("abc"), 1);
+
+    auto never = [](const auto& ...) { FAIL(); };
+    for (std::size_t n = 0; n < buffer.size(); ++n) {
+        EXPECT_FALSE(codec::decode_views(buffer.data(), n, never));
+    }
+    buffer.push_back(0);
+    EXPECT_FALSE(codec::decode_views(buffer.data(), buffer.size(), never));
+
+    // a length larger than the input
+    std::uint32_t huge = 0xffffffff;
+    std::memcpy(buffer.data(), &huge, sizeof(huge));
+    EXPECT_FALSE(codec::decode_views(buffer.data(), buffer.size() - 1, never));
+}
+
+// Test the customization point for user types
+TEST(CodecTest, UserType) {
+    using codec = sigslot::codec<Shape>;
+    const Shape shape{"triangle", {{0, 0}, {4, 0}, {0, 3}}};
+
+    unsigned char buffer[128];
+    const std::size_t n = codec::encode(buffer, sizeof(buffer), shape);
+    ASSERT_EQ(n, codec::size(shape));
+
+    int calls = 0;
+    EXPECT_TRUE(codec::decode(buffer, n, [&](const Shape& s) {
+        EXPECT_EQ(s.name, "triangle");
+        ASSERT_EQ(s.points.size(), 3u);
+        EXPECT_EQ(s.points[2].y, 3);
+        ++calls;
+    }));
+    EXPECT_EQ(calls, 1);
+}
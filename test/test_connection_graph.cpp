@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <string>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+
+namespace {
+
+const sigslot::graph_node* Find(const std::vector<sigslot::graph_node>& nodes, const void* signal) {
+    for (auto& n : nodes) {
+        if (n.signal == signal) {
+            return &n;
+        }
+    }
+    return nullptr;
+}
+
+const sigslot::graph_node* FindByName(const std::vector<sigslot::graph_node>& nodes, const std::string& name) {
+    for (auto& n : nodes) {
+        if (n.name == name) {
+            return &n;
+        }
+    }
+    return nullptr;
+}
+
+// waits for the tasks posted to a queue so far
+void Flush(core::TaskQueue* queue) {
+    std::promise<void> done;
+    queue->PostTask([&done]() { done.set_value(); });
+    done.get_future().wait();
+}
+
+} // namespace
+
+class ConnectionGraphTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sigslot::connection_graph::enable();
+    }
+
+    void TearDown() override {
+        sigslot::connection_graph::disable();
+    }
+};
+
+// Test tracked signals report their slots, targets and delivery counts
+TEST_F(ConnectionGraphTest, Snapshot) {
+    auto queue = core::TaskQueue::Create("graph_worker");
+
+    sigslot::signal<int> frames;
+    sigslot::signal<int> chained;
+    EXPECT_TRUE(sigslot::connection_graph::set_name(frames, "frames"));
+
+    int direct = 0;
+    int queued = 0;
+    frames.connect([&direct](int) { ++direct; });
+    frames.connect([&queued](int) { ++queued; }, sigslot::connection_type::queued_connection, queue.get());
+    sigslot::connect(frames, chained);
+    auto blocked = frames.connect([](int) {}, sigslot::connection_type::direct_connection, nullptr, 1);
+    blocked.block();
+
+    for (int i = 0; i < 3; ++i) {
+        frames(i);
+    }
+    Flush(queue.get());
+
+    auto nodes = sigslot::connection_graph::snapshot();
+    auto* node = Find(nodes, &frames);
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(node->name, "frames");
+    ASSERT_EQ(node->edges.size(), 4u);
+
+    auto& d = node->edges[0];
+    EXPECT_EQ(d.type, sigslot::connection_type::direct_connection);
+    EXPECT_TRUE(d.queues.empty());
+    EXPECT_EQ(d.deliveries, 3u);
+
+    auto& q = node->edges[1];
+    EXPECT_EQ(q.type, sigslot::connection_type::queued_connection);
+    ASSERT_EQ(q.queues.size(), 1u);
+    EXPECT_EQ(q.queues[0], "graph_worker");
+    EXPECT_EQ(q.deliveries, 3u);
+    EXPECT_EQ(queued, 3);
+
+    auto& c = node->edges[2];
+    EXPECT_EQ(c.target, &chained);
+    EXPECT_EQ(c.deliveries, 3u);
+
+    auto& b = node->edges[3];
+    EXPECT_EQ(b.group, 1);
+    EXPECT_TRUE(b.blocked);
+    EXPECT_EQ(b.deliveries, 0u);
+
+    auto* target = Find(nodes, &chained);
+    ASSERT_NE(target, nullptr);
+    EXPECT_TRUE(target->edges.empty());
+}
+
+// Test destroyed signals leave the graph
+TEST_F(ConnectionGraphTest, Unregister) {
+    {
+        sigslot::signal<> sig;
+        EXPECT_TRUE(sigslot::connection_graph::set_name(sig, "unregister"));
+        EXPECT_NE(FindByName(sigslot::connection_graph::snapshot(), "unregister"), nullptr);
+    }
+    EXPECT_EQ(FindByName(sigslot::connection_graph::snapshot(), "unregister"), nullptr);
+}
+
+// Test signals created once disabled are not tracked
+TEST_F(ConnectionGraphTest, Disable) {
+    sigslot::signal<> tracked;
+    sigslot::connection_graph::disable();
+    EXPECT_FALSE(sigslot::connection_graph::enabled());
+
+    sigslot::signal<> untracked;
+    EXPECT_FALSE(sigslot::connection_graph::set_name(untracked, "untracked"));
+    EXPECT_TRUE(sigslot::connection_graph::set_name(tracked, "tracked"));
+}
+
+// Test the DOT and JSON exports
+TEST_F(ConnectionGraphTest, Export) {
+    auto queue = core::TaskQueue::Create("graph_\"export\"");
+    sigslot::signal<int> sig;
+    sigslot::connection_graph::set_name(sig, "export");
+    sig.connect([](int) {});
+    sig.connect([](int) {}, sigslot::connection_type::blocking_queued_connection, queue.get());
+    sig(1);
+
+    auto nodes = sigslot::connection_graph::snapshot();
+    std::vector<sigslot::graph_node> mine;
+    mine.push_back(*Find(nodes, &sig));
+
+    const auto dot = sigslot::connection_graph::to_dot(mine);
+    EXPECT_EQ(dot.rfind("digraph sigslot {\n", 0), 0u);
+    EXPECT_NE(dot.find("label=\"export\\n2 slots\""), std::string::npos);
+    EXPECT_NE(dot.find("\"queue:graph_\\\"export\\\"\" [shape=ellipse"), std::string::npos);
+    EXPECT_NE(dot.find("-> \"caller\" [label=\"direct\\n1\""), std::string::npos);
+    EXPECT_NE(dot.find("label=\"blocking_queued\\n1\",penwidth=1.3,color=red"), std::string::npos);
+
+    const auto json = sigslot::connection_graph::to_json(mine);
+    EXPECT_NE(json.find("\"name\":\"export\""), std::string::npos);
+    EXPECT_NE(json.find("{\"type\":\"direct\",\"group\":0,\"queues\":[],\"object\":null,\"target\":null,"
+                        "\"deliveries\":1,\"blocked\":false}"), std::string::npos);
+    EXPECT_NE(json.find("\"queues\":[\"graph_\\\"export\\\"\"]"), std::string::npos);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "./signal-slot/core/task_queue_manager.hpp"
+
+class EventBusTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TQMgr->create({"worker"});
+    }
+
+    void TearDown() override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    struct DevicePlugged {
+        std::string deviceId;
+    };
+
+    struct VolumeChanged {
+        int volume;
+    };
+
+    struct Receiver {
+        void onVolume(const VolumeChanged& e) {
+            lastVolume = e.volume;
+            executionThreadId = std::this_thread::get_id();
+        }
+
+        int lastVolume = 0;
+        std::thread::id executionThreadId;
+    };
+};
+
+// Test events are dispatched by type
+TEST_F(EventBusTest, PublishSubscribe) {
+    sigslot::event_bus bus;
+    std::string lastDevice;
+    Receiver receiver;
+
+    bus.subscribe<DevicePlugged>([&](const DevicePlugged& e) { lastDevice = e.deviceId; });
+    bus.subscribe<VolumeChanged>(&receiver, &Receiver::onVolume);
+
+    bus.publish(DevicePlugged{"cam"});
+    EXPECT_EQ(lastDevice, "cam");
+    EXPECT_EQ(receiver.lastVolume, 0);
+
+    bus.publish(VolumeChanged{7});
+    EXPECT_EQ(receiver.lastVolume, 7);
+    EXPECT_EQ(lastDevice, "cam");
+
+    // No subscriber, nothing happens
+    bus.publish(42);
+    EXPECT_EQ(bus.subscriber_count<int>(), 0u);
+    EXPECT_EQ(bus.subscriber_count<VolumeChanged>(), 1u);
+}
+
+// Test subscriptions support connection types and task queues
+TEST_F(EventBusTest, QueuedSubscription) {
+    sigslot::event_bus bus;
+    Receiver receiver;
+    auto mainThreadId = std::this_thread::get_id();
+
+    auto conn = bus.subscribe<VolumeChanged>(&receiver, &Receiver::onVolume,
+                                             sigslot::connection_type::queued_connection, TQ("worker"));
+    bus.publish(VolumeChanged{3});
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(receiver.lastVolume, 3);
+    EXPECT_NE(receiver.executionThreadId, mainThreadId);
+
+    conn.disconnect();
+    bus.publish(VolumeChanged{4});
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(receiver.lastVolume, 3);
+}
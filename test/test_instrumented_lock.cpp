@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "../signal-slot/core/task_queue_base.hpp"
+#include "../signal-slot/core/task_queue_stdlib.hpp"
+
+namespace {
+
+using profiled_mutex = sigslot::instrumented_lock<std::mutex>;
+
+struct Receiver : sigslot::observer_base<profiled_mutex> {
+    ~Receiver() override { disconnect_all(); }
+    void slot(int i) { sum += i; }
+    using sigslot::observer_base<profiled_mutex>::lockable;
+    int sum = 0;
+};
+
+} // namespace
+
+// Test contended acquisitions are counted with their wait and hold times
+TEST(InstrumentedLockTest, Contention) {
+    profiled_mutex m;
+    std::promise<void> held;
+    std::thread holder([&m, &held]() {
+        std::lock_guard<profiled_mutex> _{m};
+        held.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    held.get_future().wait();
+    {
+        std::lock_guard<profiled_mutex> _{m};
+    }
+    holder.join();
+    EXPECT_TRUE(m.try_lock());
+    m.unlock();
+
+    auto stats = m.stats();
+    EXPECT_EQ(stats.acquisitions, 3u);
+    EXPECT_EQ(stats.contended, 1u);
+    EXPECT_EQ(stats.wait.count, 3u);
+    EXPECT_EQ(stats.hold.count, 3u);
+    EXPECT_GE(stats.wait.percentile(1.0), std::chrono::milliseconds(5));
+    EXPECT_GE(stats.hold.percentile(1.0), std::chrono::milliseconds(20));
+    EXPECT_LT(stats.wait.percentile(0.5), std::chrono::microseconds(1));
+
+    m.reset();
+    EXPECT_EQ(m.stats().acquisitions, 0u);
+
+    // a disabled lock records nothing
+    profiled_mutex off(false);
+    off.lock();
+    off.unlock();
+    EXPECT_EQ(off.stats().acquisitions, 0u);
+}
+
+// Test the lock policy of signals and observers
+TEST(InstrumentedLockTest, SignalAndObserver) {
+    sigslot::signal_base<profiled_mutex, int> sig;
+    Receiver r;
+    sig.connect(&r, &Receiver::slot);
+    sig.connect([](int) {});
+    sig(1);
+    sig(2);
+    EXPECT_EQ(r.sum, 3);
+
+    // connections and emissions take the slots lock
+    auto stats = sig.lockable().stats();
+    EXPECT_GE(stats.acquisitions, 4u);
+    EXPECT_EQ(stats.hold.count, stats.acquisitions);
+    EXPECT_GE(r.lockable().stats().acquisitions, 1u);
+}
+
+// Test the locks of TaskQueueStdlib once profiled
+TEST(InstrumentedLockTest, TaskQueueLocks) {
+    core::TaskQueueStdlib::ProfileLocks(true);
+    auto queue = core::TaskQueue::Create("profiled_locks");
+    core::TaskQueueStdlib::ProfileLocks(false);
+
+    std::promise<void> done;
+    for (int i = 0; i < 10; ++i) {
+        queue->PostTask([]() {});
+    }
+    queue->PostTask([&done]() { done.set_value(); });
+    done.get_future().wait();
+
+    auto *impl = static_cast<core::ProfiledTaskQueueStdlib*>(queue->Get());
+    EXPECT_GE(impl->PendingLockStats().acquisitions, 11u);
+    EXPECT_GE(impl->NotifyLockStats().acquisitions, 11u);
+
+    auto plain = core::TaskQueue::Create("plain_locks");
+    plain->PostTask([]() {});
+    EXPECT_EQ(static_cast<core::TaskQueueStdlib*>(plain->Get())->PendingLockStats().acquisitions, 0u);
+}
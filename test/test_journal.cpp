@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+
+#if defined(CORE_POSIX)
+
+class JournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "sigslot_journal_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    void TearDown() override {
+        for (std::size_t i = 0; core::MappedFile::Remove(path + "." + std::to_string(i)); ++i) {}
+    }
+
+    std::string path;
+};
+
+// Test emissions of several threads are replayed in emission order
+TEST_F(JournalTest, RecordAndReplay) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+    {
+        // small segments, each thread rolls over several times
+        sigslot::journal_recorder<int, std::string> recorder(path, 16 * 1024);
+        sigslot::signal<int, std::string> sig;
+        recorder.attach(sig);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&sig, t]() {
+                for (int i = 0; i < kPerThread; ++i) {
+                    sig(t * kPerThread + i, std::string(i % 16, 'a' + t));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        EXPECT_EQ(recorder.records(), static_cast<std::uint64_t>(kThreads * kPerThread));
+        EXPECT_EQ(recorder.dropped(), 0u);
+    }
+
+    // other argument types do not match the journal
+    EXPECT_TRUE(sigslot::journal_replayer<int>(path).empty());
+
+    sigslot::journal_replayer<int, std::string> replayer(path);
+    ASSERT_EQ(replayer.size(), static_cast<std::size_t>(kThreads * kPerThread));
+
+    std::vector<int> last(kThreads, -1);
+    sigslot::signal<int, std::string> replayed;
+    int calls = 0;
+    replayed.connect([&](int value, const std::string& text) {
+        const int t = value / kPerThread;
+        const int i = value % kPerThread;
+        EXPECT_GT(i, last[t]);
+        EXPECT_EQ(text, std::string(i % 16, 'a' + t));
+        last[t] = i;
+        ++calls;
+    });
+    EXPECT_EQ(replayer.replay(replayed, 0), static_cast<std::size_t>(kThreads * kPerThread));
+    EXPECT_EQ(calls, kThreads * kPerThread);
+}
+
+// Test replay follows the recorded pace, scaled by the speed
+TEST_F(JournalTest, ReplayPace) {
+    {
+        sigslot::journal_recorder<int> recorder(path);
+        for (int i = 0; i < 5; ++i) {
+            recorder(i);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    sigslot::journal_replayer<int> replayer(path);
+    ASSERT_EQ(replayer.size(), 5u);
+    EXPECT_GE(replayer.span(), std::chrono::milliseconds(80));
+
+    std::vector<int> values;
+    const auto start = std::chrono::steady_clock::now();
+    replayer.replay([&values](int v) { values.push_back(v); }, 2.0);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_GE(elapsed, std::chrono::milliseconds(40));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(80));
+}
+
+// Test segments failing to be created leave no gap in the journal
+TEST_F(JournalTest, SegmentCreationFailure) {
+    const std::filesystem::path dir = path + "_dir";
+    const std::filesystem::path moved = path + "_moved";
+    std::filesystem::remove_all(dir);
+    std::filesystem::remove_all(moved);
+    std::filesystem::create_directories(dir);
+    const std::string journal = (dir / "journal").string();
+
+    std::uint64_t recorded = 0;
+    {
+        sigslot::journal_recorder<int> recorder(journal, 4096);
+        for (int i = 0; i < 200; ++i) {
+            recorder(i);
+        }
+        // the segments can no longer be created
+        std::filesystem::rename(dir, moved);
+        for (int i = 200; i < 400; ++i) {
+            recorder(i);
+        }
+        EXPECT_GT(recorder.dropped(), 0u);
+        std::filesystem::rename(moved, dir);
+        for (int i = 400; i < 600; ++i) {
+            recorder(i);
+        }
+        recorded = recorder.records();
+    }
+
+    sigslot::journal_replayer<int> replayer(journal);
+    EXPECT_EQ(replayer.size(), recorded);
+    std::filesystem::remove_all(dir);
+}
+
+#endif
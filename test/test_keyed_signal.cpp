@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "./signal-slot/core/task_queue_manager.hpp"
+
+class KeyedSignalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TQMgr->create({"worker"});
+    }
+
+    void TearDown() override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    struct DeviceReceiver {
+        void onStatus(int status) {
+            lastStatus = status;
+            callCount++;
+        }
+
+        int lastStatus = 0;
+        int callCount = 0;
+    };
+};
+
+// Test emissions are only delivered to the slots of the emitted key
+TEST_F(KeyedSignalTest, DispatchByKey) {
+    sigslot::keyed_signal<std::string, int> statusChanged;
+    DeviceReceiver cam, mic;
+
+    statusChanged.connect("cam", &cam, &DeviceReceiver::onStatus);
+    statusChanged.connect("mic", &mic, &DeviceReceiver::onStatus);
+
+    statusChanged("cam", 1);
+    EXPECT_EQ(cam.callCount, 1);
+    EXPECT_EQ(cam.lastStatus, 1);
+    EXPECT_EQ(mic.callCount, 0);
+
+    statusChanged("mic", 2);
+    statusChanged("unknown", 3);
+    EXPECT_EQ(cam.callCount, 1);
+    EXPECT_EQ(mic.callCount, 1);
+    EXPECT_EQ(mic.lastStatus, 2);
+    EXPECT_EQ(statusChanged.key_count(), 2u);
+}
+
+// Test connection types and disconnection per key
+TEST_F(KeyedSignalTest, ConnectionManagement) {
+    sigslot::keyed_signal<int, int> statusChanged;
+    DeviceReceiver first, second;
+    auto mainThreadId = std::this_thread::get_id();
+    std::thread::id queuedThreadId;
+
+    auto conn = statusChanged.connect(1, &first, &DeviceReceiver::onStatus);
+    statusChanged.connect(1, [&](int) { queuedThreadId = std::this_thread::get_id(); },
+                          sigslot::connection_type::queued_connection, TQ("worker"));
+    statusChanged.connect(2, &second, &DeviceReceiver::onStatus);
+    EXPECT_EQ(statusChanged.slot_count(1), 2u);
+
+    statusChanged(1, 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(first.callCount, 1);
+    EXPECT_NE(queuedThreadId, std::thread::id());
+    EXPECT_NE(queuedThreadId, mainThreadId);
+
+    conn.disconnect();
+    statusChanged(1, 11);
+    EXPECT_EQ(first.callCount, 1);
+
+    EXPECT_EQ(statusChanged.disconnect(2), 1u);
+    statusChanged(2, 12);
+    EXPECT_EQ(second.callCount, 0);
+    EXPECT_EQ(statusChanged.key_count(), 1u);
+}
+
+// Test keys whose slots were disconnected one by one are pruned
+TEST_F(KeyedSignalTest, PruneEmptyKeys) {
+    sigslot::keyed_signal<int, int> statusChanged;
+    DeviceReceiver kept;
+    statusChanged.connect(-1, &kept, &DeviceReceiver::onStatus);
+
+    for (int key = 0; key < 1000; ++key) {
+        DeviceReceiver gone;
+        sigslot::scoped_connection conn = statusChanged.connect(key, &gone, &DeviceReceiver::onStatus);
+        statusChanged(key, key);
+        EXPECT_EQ(gone.callCount, 1);
+    }
+    EXPECT_LE(statusChanged.key_count(), 16u);
+
+    statusChanged(-1, 1);
+    EXPECT_EQ(kept.callCount, 1);
+    EXPECT_EQ(statusChanged.slot_count(-1), 1u);
+}
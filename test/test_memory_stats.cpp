@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+
+namespace {
+
+struct Tracked : sigslot::observer {
+    void slot(int) {}
+};
+
+const sigslot::slot_memory_stats* FindSlot(const sigslot::memory_report& r, const std::string& part) {
+    for (auto& s : r.slots) {
+        if (s.type.find(part) != std::string::npos) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+const sigslot::queue_memory_stats* FindQueue(const sigslot::memory_report& r, const std::string& name) {
+    for (auto& q : r.queues) {
+        if (q.queue == name) {
+            return &q;
+        }
+    }
+    return nullptr;
+}
+
+struct MemoryStatsTag {
+    void operator()(int) const {}
+};
+
+} // namespace
+
+// Test slots are accounted by type as they are connected and disconnected
+TEST(MemoryStatsTest, SlotsByType) {
+    const auto before = sigslot::memory_stats();
+    {
+        sigslot::signal<int> sig;
+        for (int i = 0; i < 10; ++i) {
+            sig.connect(MemoryStatsTag{});
+        }
+
+        const auto r = sigslot::memory_stats();
+        const auto *s = FindSlot(r, "MemoryStatsTag");
+        ASSERT_NE(s, nullptr);
+        EXPECT_EQ(s->usage.objects, 10u);
+        EXPECT_GE(s->usage.bytes, 10u * sizeof(sigslot::detail::slot_base<int>));
+        EXPECT_GT(r.slot_lists.bytes, before.slot_lists.bytes);
+        EXPECT_GT(r.total_bytes(), before.total_bytes());
+
+        sig.disconnect_all();
+        EXPECT_EQ(FindSlot(sigslot::memory_stats(), "MemoryStatsTag"), nullptr);
+    }
+    const auto after = sigslot::memory_stats();
+    EXPECT_EQ(after.slot_lists.objects, before.slot_lists.objects);
+    EXPECT_EQ(after.slot_lists.bytes, before.slot_lists.bytes);
+}
+
+// Test copy on write payloads and the copies made by writers
+TEST(MemoryStatsTest, CopyOnWrite) {
+    const auto before = sigslot::memory_stats();
+    {
+        sigslot::signal<int> sig;
+        EXPECT_EQ(sigslot::memory_stats().cow_payloads.objects, before.cow_payloads.objects + 1);
+
+        // connecting while emitting copies the list held by the emission
+        sig.connect([&sig](int) {
+            sig.connect([](int) {});
+        });
+        const auto copies = sigslot::memory_stats().cow_copies;
+        sig(1);
+        EXPECT_EQ(sigslot::memory_stats().cow_copies, copies + 1);
+    }
+    EXPECT_EQ(sigslot::memory_stats().cow_payloads.objects, before.cow_payloads.objects);
+}
+
+// Test observers account their connection list
+TEST(MemoryStatsTest, Observers) {
+    const auto before = sigslot::memory_stats();
+    {
+        sigslot::signal<int> sig;
+        std::vector<Tracked> observers(5);
+        for (auto& o : observers) {
+            sig.connect(&o, &Tracked::slot);
+        }
+        const auto r = sigslot::memory_stats();
+        EXPECT_EQ(r.observers.objects, before.observers.objects + 5);
+        EXPECT_GT(r.observers.bytes, before.observers.bytes);
+    }
+    EXPECT_EQ(sigslot::memory_stats().observers.objects, before.observers.objects);
+}
+
+// Test the waiting tasks of a queue are reported with their captures
+TEST(MemoryStatsTest, QueuedTasks) {
+    auto queue = core::TaskQueue::Create("memory_stats_queue");
+    std::promise<void> release;
+    std::promise<void> running;
+    queue->PostTask([&running, gate = release.get_future().share()]() {
+        running.set_value();
+        gate.wait();
+    });
+    running.get_future().wait();
+
+    std::array<char, 512> payload{};
+    for (int i = 0; i < 3; ++i) {
+        queue->PostTask([payload]() { (void)payload; });
+    }
+    const auto nodes = sigslot::memory_stats().delayed_nodes;
+    queue->PostDelayedTask([payload]() { (void)payload; }, std::chrono::hours(1));
+
+    const auto r = sigslot::memory_stats();
+    const auto *q = FindQueue(r, "memory_stats_queue");
+    ASSERT_NE(q, nullptr);
+    EXPECT_EQ(q->usage.pending_tasks, 3u);
+    EXPECT_GE(q->usage.pending_bytes, 3 * payload.size());
+    EXPECT_EQ(q->usage.delayed_tasks, 1u);
+    EXPECT_GE(q->usage.delayed_bytes, payload.size());
+    EXPECT_EQ(r.delayed_nodes.objects, nodes.objects + 1);
+    EXPECT_NE(r.report().find("memory_stats_queue"), std::string::npos);
+
+    release.set_value();
+    queue.reset();
+    EXPECT_EQ(FindQueue(sigslot::memory_stats(), "memory_stats_queue"), nullptr);
+    EXPECT_EQ(sigslot::memory_stats().delayed_nodes.objects, nodes.objects);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "../signal-slot/core/shared_memory.hpp"
+#include "../signal-slot/core/task_queue_manager.hpp"
+
+#if defined(CORE_POSIX)
+
+namespace {
+
+// metrics are process wide, the region is created by the first test needing it
+bool EnableMetrics() {
+    return core::Metrics::Enable() || core::Metrics::Enabled();
+}
+
+const core::MetricsSnapshot* Find(const std::vector<core::MetricsSnapshot>& entries, const std::string& name) {
+    for (auto& e : entries) {
+        if (e.name == name) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+// waits for the worker of a queue to publish count tasks
+core::MetricsSnapshot WaitForTasks(const std::string& name, uint64_t count) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (;;) {
+        auto entries = core::Metrics::Snapshot();
+        auto* e = Find(entries, name);
+        if ((e && e->count >= count) || std::chrono::steady_clock::now() > deadline) {
+            return e ? *e : core::MetricsSnapshot{};
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+// Test queues publish their tasks, and release their entry when destroyed
+TEST(MetricsTest, QueueCounters) {
+    ASSERT_TRUE(EnableMetrics());
+    {
+        auto queue = core::TaskQueue::Create("metrics_queue");
+        for (int i = 0; i < 10; ++i) {
+            queue->PostTask([]() { std::this_thread::sleep_for(std::chrono::microseconds(100)); });
+        }
+        queue->PostDelayedTask([]() {}, std::chrono::milliseconds(5));
+
+        auto e = WaitForTasks("metrics_queue", 11);
+        EXPECT_EQ(e.kind, core::MetricsKind::kQueue);
+        EXPECT_EQ(e.count, 11u);
+        EXPECT_EQ(e.wait.count, 11u);
+        EXPECT_EQ(e.run.count, 11u);
+        EXPECT_GE(e.run.total_ns, 10u * 100000u);
+        EXPECT_GE(e.run.Percentile(0.5), std::chrono::microseconds(100));
+    }
+    EXPECT_EQ(Find(core::Metrics::Snapshot(), "metrics_queue"), nullptr);
+}
+
+// Test instrumented signals count emissions, deliveries and drops
+TEST(MetricsTest, SignalCounters) {
+    ASSERT_TRUE(EnableMetrics());
+    sigslot::signal<int> sig;
+    ASSERT_TRUE(sig.instrument("metrics_signal"));
+    EXPECT_TRUE(sig.instrumented());
+
+    sig(0);
+    int sum = 0;
+    sig.connect([&sum](int i) { sum += i; });
+    sig.connect([&sum](int i) { sum += i; });
+    for (int i = 1; i <= 5; ++i) {
+        sig(i);
+    }
+    sig.block();
+    sig(100);
+    EXPECT_EQ(sum, 30);
+
+    auto entries = core::Metrics::Snapshot();
+    auto* e = Find(entries, "metrics_signal");
+    ASSERT_NE(e, nullptr);
+    EXPECT_EQ(e->kind, core::MetricsKind::kSignal);
+    EXPECT_EQ(e->count, 7u);
+    EXPECT_EQ(e->deliveries, 10u);
+    EXPECT_EQ(e->drops, 2u);
+    EXPECT_EQ(e->run.count, 6u);
+
+    // moving the signal moves its entry
+    sigslot::signal<int> moved(std::move(sig));
+    EXPECT_TRUE(moved.instrumented());
+    EXPECT_FALSE(sig.instrumented());
+}
+
+// Test the region reads the same from another mapping, as sigslot_top does
+TEST(MetricsTest, ExternalReader) {
+    ASSERT_TRUE(EnableMetrics());
+    sigslot::signal<> sig;
+    ASSERT_TRUE(sig.instrument("metrics_external"));
+    sig.connect([]() {});
+    sig();
+    sig();
+
+    auto region = core::SharedMemory::Open(core::Metrics::RegionName());
+    ASSERT_NE(region, nullptr);
+    auto entries = core::Metrics::Read(region->Data(), region->Size());
+    auto* e = Find(entries, "metrics_external");
+    ASSERT_NE(e, nullptr);
+    EXPECT_EQ(e->count, 2u);
+    EXPECT_EQ(e->deliveries, 2u);
+
+    // not a stats region
+    std::vector<unsigned char> garbage(4096, 0x5a);
+    EXPECT_TRUE(core::Metrics::Read(garbage.data(), garbage.size()).empty());
+}
+
+// Test the OpenMetrics dump
+TEST(MetricsTest, OpenMetrics) {
+    ASSERT_TRUE(EnableMetrics());
+    sigslot::signal<int> sig;
+    ASSERT_TRUE(sig.instrument("metrics_\"dump\""));
+    sig.connect([](int) {});
+    sig(1);
+
+    const std::string path = ::testing::TempDir() + "sigslot_metrics.txt";
+    ASSERT_TRUE(core::Metrics::DumpOpenMetrics(path));
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    std::remove(path.c_str());
+
+    const auto out = text.str();
+    EXPECT_NE(out.find("# TYPE sigslot_signal_emissions counter\n"), std::string::npos);
+    EXPECT_NE(out.find("sigslot_signal_emissions_total{signal=\"metrics_\\\"dump\\\"\"} 1\n"), std::string::npos);
+    EXPECT_NE(out.find("sigslot_signal_emit_seconds_count{signal=\"metrics_\\\"dump\\\"\"} 1\n"), std::string::npos);
+    EXPECT_NE(out.find("le=\"+Inf\"} 1\n"), std::string::npos);
+    ASSERT_GE(out.size(), 6u);
+    EXPECT_EQ(out.substr(out.size() - 6), "# EOF\n");
+}
+
+// Test a queue owned by a static, created once metrics are enabled, releases
+// its entry at exit without touching an unmapped region
+TEST(MetricsTest, QueueOutlivesRegion) {
+    const std::string style = ::testing::FLAGS_gtest_death_test_style;
+    // a fresh process, so the queue manager is constructed before the region
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_EXIT({
+        TQMgr->create({"metrics_before"});
+        EnableMetrics();
+        TQMgr->create({"metrics_static"});
+        std::exit(0);
+    }, ::testing::ExitedWithCode(0), "");
+    ::testing::FLAGS_gtest_death_test_style = style;
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "./signal-slot/core/task_queue_manager.hpp"
+
+#if defined(__linux__)
+
+class RemoteSignalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TQMgr->create({"worker"});
+        receiverQueue = core::TaskQueue::CreateEpoll("receiver");
+        ASSERT_NE(receiverQueue, nullptr);
+        ASSERT_TRUE(core::UnixSocketPair(fds));
+    }
+
+    void TearDown() override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    struct Quote {
+        int id;
+        double price;
+    };
+
+    std::unique_ptr<core::TaskQueue> receiverQueue;
+    int fds[2];
+};
+
+// Test emissions cross the socket in order, with batched writes
+TEST_F(RemoteSignalTest, SendAndReceive) {
+    sigslot::remote_sender<int, Quote> sender(fds[0], TQ("worker"));
+    sigslot::remote_receiver<int, Quote> receiver(fds[1], receiverQueue.get());
+
+    std::vector<int> received;
+    std::atomic<int> calls{0};
+    std::thread::id thread;
+    receiver.connect([&](int seq, const Quote& q) {
+        EXPECT_EQ(q.id, seq);
+        EXPECT_DOUBLE_EQ(q.price, seq * 0.25);
+        received.push_back(seq);
+        thread = std::this_thread::get_id();
+        ++calls;
+    });
+
+    sigslot::signal<int, Quote> sig;
+    sender.attach(sig);
+    for (int i = 0; i < 10000; ++i) {
+        sig(i, Quote{i, i * 0.25});
+    }
+
+    for (int i = 0; i < 400 && calls < 10000; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(calls, 10000);
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_EQ(received[i], i);
+    }
+    EXPECT_EQ(sender.frames(), 10000u);
+    EXPECT_LT(sender.writes(), sender.frames());
+    EXPECT_FALSE(receiver.closed());
+
+    std::promise<std::thread::id> queueThread;
+    receiverQueue->PostTask([&queueThread]() { queueThread.set_value(std::this_thread::get_id()); });
+    EXPECT_EQ(thread, queueThread.get_future().get());
+}
+
+// Test variable size arguments go through the codec
+TEST_F(RemoteSignalTest, StringsAndVectors) {
+    sigslot::remote_sender<std::string, std::vector<int>> sender(fds[0], TQ("worker"));
+    sigslot::remote_receiver<std::string, std::vector<int>> receiver(fds[1], receiverQueue.get());
+
+    std::vector<std::string> names;
+    std::atomic<int> calls{0};
+    receiver.connect([&](const std::string& name, const std::vector<int>& values) {
+        EXPECT_EQ(values.size(), name.size());
+        names.push_back(name);
+        ++calls;
+    });
+
+    for (int i = 0; i < 100; ++i) {
+        sender(std::string(i, 'x'), std::vector<int>(i, i));
+    }
+    for (int i = 0; i < 400 && calls < 100; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(calls, 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(names[i].size(), static_cast<std::size_t>(i));
+    }
+}
+
+// Test the receiver notices the sender going away
+TEST_F(RemoteSignalTest, SenderClosed) {
+    sigslot::remote_receiver<int> receiver(fds[1], receiverQueue.get());
+    {
+        sigslot::remote_sender<int> sender(fds[0], TQ("worker"));
+        sender(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    for (int i = 0; i < 100 && !receiver.closed(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(receiver.closed());
+}
+
+#endif
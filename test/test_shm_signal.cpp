@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+#include "./signal-slot/core/task_queue_manager.hpp"
+
+#if defined(CORE_POSIX)
+
+class ShmSignalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TQMgr->create({"receiver"});
+        name = "sigslot_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+               "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    std::string name;
+};
+
+struct Sample {
+    int id;
+    double value;
+};
+
+// Test emissions go through the segment and are re-emitted on the receiving queue
+TEST_F(ShmSignalTest, EmitAcrossMappings) {
+    auto receiver = sigslot::shm_signal<int, Sample>::create(name, 16);
+    ASSERT_NE(receiver, nullptr);
+    auto emitter = sigslot::shm_signal<int, Sample>::open(name);
+    ASSERT_NE(emitter, nullptr);
+
+    // peers built with other argument types are rejected
+    EXPECT_EQ(sigslot::shm_signal<std::uint64_t>::open(name), nullptr);
+
+    std::vector<int> received;
+    std::atomic<int> calls{0};
+    std::thread::id thread;
+    receiver->connect([&](int seq, const Sample& s) {
+        EXPECT_EQ(s.id, seq);
+        EXPECT_DOUBLE_EQ(s.value, seq * 0.5);
+        received.push_back(seq);
+        thread = std::this_thread::get_id();
+        ++calls;
+    });
+
+    // emissions queued before the receiver starts are kept
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(emitter->try_emit(i, Sample{i, i * 0.5}));
+    }
+    EXPECT_EQ(emitter->pending(), 10u);
+
+    ASSERT_TRUE(receiver->start(TQ("receiver")));
+    EXPECT_FALSE(emitter->start(TQ("receiver")));
+
+    std::thread producer([&emitter]() {
+        for (int i = 10; i < 1000; ++i) {
+            (*emitter)(i, Sample{i, i * 0.5});
+        }
+    });
+    producer.join();
+
+    for (int i = 0; i < 200 && calls < 1000; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    receiver->stop();
+
+    ASSERT_EQ(calls, 1000);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(received[i], i);
+    }
+    EXPECT_EQ(receiver->pending(), 0u);
+
+    std::promise<std::thread::id> queueThread;
+    TQ("receiver")->PostTask([&queueThread]() { queueThread.set_value(std::this_thread::get_id()); });
+    EXPECT_EQ(thread, queueThread.get_future().get());
+}
+
+// Test stopping from the receiving queue, while a drain task may be pending
+TEST_F(ShmSignalTest, StopFromQueue) {
+    auto receiver = sigslot::shm_signal<int>::create(name, 16);
+    ASSERT_NE(receiver, nullptr);
+    std::promise<void> stopped;
+    receiver->connect([&receiver, &stopped](int) {
+        receiver->stop();
+        stopped.set_value();
+    });
+
+    // the drain task is queued behind stop(), which must not wait for it
+    std::promise<void> gate;
+    std::promise<void> done;
+    ASSERT_TRUE(receiver->start(TQ("receiver")));
+    TQ("receiver")->PostTask([blocked = gate.get_future().share()]() { blocked.wait(); });
+    TQ("receiver")->PostTask([&receiver, &done]() {
+        receiver->stop();
+        done.set_value();
+    });
+    EXPECT_TRUE(receiver->try_emit(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gate.set_value();
+    EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(receiver->pending(), 1u);
+
+    // and from a slot of the local signal
+    ASSERT_TRUE(receiver->start(TQ("receiver")));
+    EXPECT_EQ(stopped.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    // the drain task calling the slot returns before the signal goes away
+    std::promise<void> idle;
+    TQ("receiver")->PostTask([&idle]() { idle.set_value(); });
+    idle.get_future().wait();
+}
+
+#endif
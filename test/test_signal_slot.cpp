@@ -1,12 +1,22 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <string>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
 #include <thread>
 #include <chrono>
+#include <filesystem>
 #include <vector>
 #include "../signal-slot/signal_slot_api.hpp"
 #include "./signal-slot/core/task_queue.hpp"
 #include "./signal-slot/core/task_queue_manager.hpp"
+#include "./signal-slot/core/task_queue_simulated.hpp"
 
 class SignalSlotTest : public ::testing::Test {
 protected:
@@ -17,6 +27,10 @@ protected:
     void TearDown() override {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+
+    // queued deliveries run from RunUntilIdle(), without waiting for a thread
+    core::SimulatedClock clock;
+    std::unique_ptr<core::TaskQueue> simulated = core::TaskQueue::CreateSimulated("simulated", clock);
 };
 
 // Test data structure
@@ -315,16 +329,16 @@ TEST_F(SignalSlotTest, AutoConnection) {
 
     // Test queued connection
     CONNECT(emitter, singleParamSignal, receiver.get(), SLOT(TestReceiver::onSingleParam),
-            sigslot::connection_type::queued_connection, TQ("worker"));
+            sigslot::connection_type::queued_connection, simulated.get());
 
     // Emit from another thread - should execute through queue
     std::thread t([emitter]() {
         EMIT(emitter->singleParamSignal, 43);
     });
     t.join();
-    
-    // Wait for queue execution to complete
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Run the queue
+    clock.RunUntilIdle();
     EXPECT_TRUE(receiver->singleParamCalled);
     EXPECT_EQ(receiver->lastValue, 43);
 
@@ -354,23 +368,23 @@ TEST_F(SignalSlotTest, CombinedConnectionTypes) {
            sigslot::connection_type::queued_connection | 
            sigslot::connection_type::unique_connection |
            sigslot::connection_type::singleshot_connection,
-           TQ("worker"));
+           simulated.get());
 
     // Try to connect the same handler again
     CONNECT(emitter, singleParamSignal, handler,
            sigslot::connection_type::queued_connection | 
            sigslot::connection_type::unique_connection |
            sigslot::connection_type::singleshot_connection,
-           TQ("worker"));
+           simulated.get());
 
     // Emit signal and wait for queue execution
     EMIT(emitter->singleParamSignal, 42);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_EQ(callCount, 1);  // Should be called only once
 
     // Emit signal again
     EMIT(emitter->singleParamSignal, 43);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_EQ(callCount, 1);  // Should not be called again due to single-shot
 }
 
@@ -423,6 +437,10 @@ protected:
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
+    // queued deliveries run from RunUntilIdle(), without waiting for a thread
+    core::SimulatedClock clock;
+    std::unique_ptr<core::TaskQueue> simulated = core::TaskQueue::CreateSimulated("simulated", clock);
+
     struct TestSignalEmitter {
         SIGNAL(testSignal, int);
     };
@@ -512,17 +530,16 @@ TEST_F(ConnectionTypesTest, DirectConnection) {
 TEST_F(ConnectionTypesTest, QueuedConnection) {
     auto emitter = std::make_shared<TestSignalEmitter>();
     auto receiver = std::make_shared<TestSlotReceiver>();
-    auto mainThreadId = std::this_thread::get_id();
-
     CONNECT(emitter, testSignal, receiver.get(), SLOT(TestSlotReceiver::onSignal),
-            sigslot::connection_type::queued_connection, TQ("worker"));
+            sigslot::connection_type::queued_connection, simulated.get());
 
     // Emit and verify asynchronous execution
     EMIT(emitter->testSignal, 1);
     EXPECT_FALSE(receiver->executed); // Should not execute immediately
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    EXPECT_TRUE(receiver->executed);
-    EXPECT_NE(receiver->executionThreadId, mainThreadId); // Should execute in worker thread
+    EXPECT_EQ(simulated->PendingTasks(), 1u);
+    clock.RunUntilIdle();
+    EXPECT_TRUE(receiver->executed); // Should execute once the queue runs
+    EXPECT_EQ(receiver->lastValue, 1);
 }
 
 // Test blocking_queued_connection behavior
@@ -551,15 +568,15 @@ TEST_F(ConnectionTypesTest, UniqueConnection) {
     // First connection
     CONNECT(emitter, testSignal, receiver.get(), SLOT(TestSlotReceiver::onSignal),
             sigslot::connection_type::queued_connection | sigslot::connection_type::unique_connection,
-            TQ("worker"));
+            simulated.get());
 
     // Try duplicate connection
     CONNECT(emitter, testSignal, receiver.get(), SLOT(TestSlotReceiver::onSignal),
             sigslot::connection_type::queued_connection | sigslot::connection_type::unique_connection,
-            TQ("worker"));
+            simulated.get());
 
     EMIT(emitter->testSignal, 1);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_EQ(receiver->callCount, 1); // Should only be called once
 }
 
@@ -570,18 +587,18 @@ TEST_F(ConnectionTypesTest, SingleshotConnection) {
 
     CONNECT(emitter, testSignal, receiver.get(), SLOT(TestSlotReceiver::onSignal),
             sigslot::connection_type::queued_connection | sigslot::connection_type::singleshot_connection,
-            TQ("worker"));
+            simulated.get());
 
     // First emission
     EMIT(emitter->testSignal, 1);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_TRUE(receiver->executed);
     EXPECT_EQ(receiver->callCount, 1);
 
     // Second emission should not trigger the slot
     receiver->reset();
     EMIT(emitter->testSignal, 2);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_FALSE(receiver->executed);
     EXPECT_EQ(receiver->callCount, 0);
 }
@@ -596,24 +613,24 @@ TEST_F(ConnectionTypesTest, CombinedConnectionTypes) {
             sigslot::connection_type::queued_connection | 
             sigslot::connection_type::unique_connection |
             sigslot::connection_type::singleshot_connection,
-            TQ("worker"));
+            simulated.get());
 
     // Try duplicate connection
     CONNECT(emitter, testSignal, receiver.get(), SLOT(TestSlotReceiver::onSignal),
             sigslot::connection_type::queued_connection | 
             sigslot::connection_type::unique_connection |
             sigslot::connection_type::singleshot_connection,
-            TQ("worker"));
+            simulated.get());
 
     // First emission
     EMIT(emitter->testSignal, 1);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_EQ(receiver->callCount, 1); // Should be called once
 
     // Second emission should not trigger due to singleshot
     receiver->reset();
     EMIT(emitter->testSignal, 2);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_EQ(receiver->callCount, 0); // Should not be called
 } 
 
@@ -808,16 +825,583 @@ TEST_F(SignalSlotTest, DisconnectionBehaviors) {
     // 6. Test disconnection with queued signals
     auto conn3 = CONNECT(emitter, singleParamSignal, receiver.get(), 
                         SLOT(TestReceiver::onSingleParam),
-                        sigslot::connection_type::queued_connection, TQ("worker"));
+                        sigslot::connection_type::queued_connection, simulated.get());
     
     EMIT(emitter->singleParamSignal, 10);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    clock.RunUntilIdle();
     EXPECT_TRUE(receiver->singleParamCalled);
     EXPECT_EQ(receiver->lastValue, 10);
 
     conn3.disconnect();
     receiver->reset();
     EMIT(emitter->singleParamSignal, 11);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(simulated->PendingTasks(), 0u);
+    clock.RunUntilIdle();
     EXPECT_FALSE(receiver->singleParamCalled);  // Should not be called after disconnection
-} 
\ No newline at end of file
+} 
+
+// Test changed_only connections
+TEST_F(ConnectionTypesTest, ChangedOnlyConnection) {
+    auto emitter = std::make_shared<TestSignalEmitter>();
+    std::vector<int> values;
+
+    CONNECT(emitter, testSignal, [&](int value) { values.push_back(value); },
+            sigslot::connection_type::direct_connection | sigslot::connection_type::changed_only, nullptr);
+
+    EMIT(emitter->testSignal, 1);
+    EMIT(emitter->testSignal, 1);
+    EMIT(emitter->testSignal, 2);
+    EMIT(emitter->testSignal, 2);
+    EMIT(emitter->testSignal, 1);
+    EXPECT_EQ(values, (std::vector<int>{1, 2, 1}));
+
+    // Suppressed emissions are not posted to the queue
+    auto receiver = std::make_shared<TestSlotReceiver>();
+    CONNECT(emitter, testSignal, receiver.get(), SLOT(TestSlotReceiver::onSignal),
+            sigslot::connection_type::queued_connection | sigslot::connection_type::changed_only, simulated.get());
+    for (int i = 0; i < 5; ++i) {
+        EMIT(emitter->testSignal, 3);
+    }
+    EXPECT_EQ(simulated->PendingTasks(), 1u);
+    clock.RunUntilIdle();
+    EXPECT_EQ(receiver->callCount, 1);
+    EXPECT_EQ(receiver->lastValue, 3);
+}
+
+// Test changed_only connections are refused for arguments without operator==
+TEST_F(ConnectionTypesTest, ChangedOnlyNotComparable) {
+    struct Opaque {
+        int value = 0;
+    };
+
+    sigslot::signal<Opaque> sig;
+    int calls = 0;
+    auto conn = sig.connect([&](Opaque) { ++calls; },
+                            sigslot::connection_type::direct_connection | sigslot::connection_type::changed_only);
+    EXPECT_FALSE(conn.valid());
+    EXPECT_EQ(sig.slot_count(), 0u);
+    sig(Opaque{});
+    EXPECT_EQ(calls, 0);
+
+    // compared through a key instead
+    sig.connect_distinct([](const Opaque& o) { return o.value; }, [&](Opaque) { ++calls; });
+    sig(Opaque{});
+    sig(Opaque{});
+    EXPECT_EQ(calls, 1);
+}
+
+// Test changed_only connections with a user supplied key
+TEST_F(SignalSlotTest, ConnectDistinct) {
+    auto emitter = std::make_shared<TestEmitter>();
+    int calls = 0;
+
+    // only the value matters, the message is ignored
+    emitter->multiParamSignal.connect_distinct(
+        [](int value, const std::string&) { return value; },
+        [&](int, const std::string&) { ++calls; });
+
+    EMIT(emitter->multiParamSignal, 1, "a");
+    EMIT(emitter->multiParamSignal, 1, "b");
+    EMIT(emitter->multiParamSignal, 2, "b");
+    EXPECT_EQ(calls, 2);
+}
+
+// Test a connection failing to construct its slot leaves no setup behind
+TEST_F(SignalSlotTest, ConnectDistinctThrowing) {
+    struct ThrowingSlot {
+        ThrowingSlot() = default;
+        ThrowingSlot(const ThrowingSlot&) { throw std::runtime_error("copy"); }
+        void operator()(int, const std::string&) const {}
+    };
+
+    auto emitter = std::make_shared<TestEmitter>();
+    const ThrowingSlot slot;
+    EXPECT_THROW(emitter->multiParamSignal.connect_distinct(
+        [](int value, const std::string&) { return value; }, slot), std::runtime_error);
+
+    // a regular connection made afterwards is not filtered
+    int calls = 0;
+    emitter->multiParamSignal.connect([&](int, const std::string&) { ++calls; });
+    EMIT(emitter->multiParamSignal, 1, "a");
+    EMIT(emitter->multiParamSignal, 1, "a");
+    EXPECT_EQ(calls, 2);
+}
+
+// Test throttled, debounced and sampled connections
+TEST_F(ConnectionTypesTest, RateLimitedConnections) {
+    auto emitter = std::make_shared<TestSignalEmitter>();
+    std::vector<int> leading, trailing, debounced, sampled;
+    auto recorder = [](std::vector<int>& values) {
+        return [&values](int value) {
+            values.push_back(value);
+        };
+    };
+
+    emitter->testSignal.connect_limited(sigslot::rate_limit::throttle(std::chrono::milliseconds(200)),
+                                        recorder(leading));
+    emitter->testSignal.connect_limited(sigslot::rate_limit::throttle(std::chrono::milliseconds(50),
+                                                                      sigslot::rate_limit::edge_type::trailing),
+                                        recorder(trailing), sigslot::connection_type::queued_connection, simulated.get());
+    emitter->testSignal.connect_limited(sigslot::rate_limit::debounce(std::chrono::milliseconds(50)),
+                                        recorder(debounced), sigslot::connection_type::queued_connection, simulated.get());
+    emitter->testSignal.connect_limited(sigslot::rate_limit::sample(3), recorder(sampled));
+
+    for (int i = 1; i <= 6; ++i) {
+        EMIT(emitter->testSignal, i);
+    }
+    clock.RunUntilIdle();
+    EXPECT_TRUE(trailing.empty());
+    EXPECT_TRUE(debounced.empty());
+    clock.AdvanceTime(std::chrono::milliseconds(50));
+
+    EXPECT_EQ(leading, (std::vector<int>{1}));
+    EXPECT_EQ(trailing, (std::vector<int>{6}));
+    EXPECT_EQ(debounced, (std::vector<int>{6}));
+    EXPECT_EQ(sampled, (std::vector<int>{3, 6}));
+}
+
+// Test deferred rate limits are refused without a queue
+TEST_F(ConnectionTypesTest, RateLimitedNeedsQueue) {
+    sigslot::signal<int> sig;
+    int calls = 0;
+
+    auto trailing = sig.connect_limited(sigslot::rate_limit::throttle(std::chrono::milliseconds(50),
+                                                                      sigslot::rate_limit::edge_type::trailing),
+                                        [&](int) { ++calls; });
+    auto debounced = sig.connect_limited(sigslot::rate_limit::debounce(std::chrono::milliseconds(50)),
+                                         [&](int) { ++calls; });
+    EXPECT_FALSE(trailing.valid());
+    EXPECT_FALSE(debounced.valid());
+    EXPECT_EQ(sig.slot_count(), 0u);
+
+    // the leading edge and sampling deliver synchronously
+    auto leading = sig.connect_limited(sigslot::rate_limit::throttle(std::chrono::milliseconds(50)),
+                                       [&](int) { ++calls; });
+    EXPECT_TRUE(leading.valid());
+    sig(1);
+    EXPECT_EQ(calls, 1);
+}
+
+// Test coalescing emissions with an emission_batch
+TEST_F(SignalSlotTest, EmissionBatch) {
+    auto emitter = std::make_shared<TestEmitter>();
+    std::vector<int> values;
+    std::vector<std::string> messages;
+
+    CONNECT(emitter, singleParamSignal, [&](int value) { values.push_back(value); });
+    CONNECT(emitter, multiParamSignal, [&](int, const std::string& msg) { messages.push_back(msg); });
+
+    {
+        sigslot::emission_batch batch;
+        EMIT(emitter->singleParamSignal, 1);
+        EMIT(emitter->multiParamSignal, 0, "a");
+        EMIT(emitter->singleParamSignal, 2);
+        EMIT(emitter->multiParamSignal, 0, "b");
+        EMIT(emitter->singleParamSignal, 3);
+        EXPECT_TRUE(values.empty());
+        EXPECT_TRUE(messages.empty());
+    }
+    EXPECT_EQ(values, (std::vector<int>{3}));
+    EXPECT_EQ(messages, (std::vector<std::string>{"b"}));
+
+    values.clear();
+    {
+        sigslot::emission_batch outer(sigslot::batch_mode::all_values);
+        {
+            sigslot::emission_batch inner;
+            EMIT(emitter->singleParamSignal, 4);
+            EMIT(emitter->singleParamSignal, 5);
+        }
+        EMIT(emitter->singleParamSignal, 6);
+        EXPECT_TRUE(values.empty());
+    }
+    EXPECT_EQ(values, (std::vector<int>{5, 6}));
+}
+
+// Test emitting a signal on a task queue
+TEST_F(ConnectionTypesTest, EmitOnQueue) {
+    auto emitter = std::make_shared<TestSignalEmitter>();
+    auto receiver = std::make_shared<TestSlotReceiver>();
+    auto autoReceiver = std::make_shared<TestSlotReceiver>();
+    CONNECT(emitter, testSignal, receiver.get(), SLOT(TestSlotReceiver::onSignal),
+            sigslot::connection_type::direct_connection);
+    CONNECT(emitter, testSignal, autoReceiver.get(), SLOT(TestSlotReceiver::onSignal),
+            sigslot::connection_type::auto_connection, simulated.get());
+
+    emitter->testSignal.emit_on(simulated.get(), 7);
+    EXPECT_FALSE(receiver->executed); // Should not execute on the emitting thread
+    EXPECT_EQ(simulated->PendingTasks(), 1u);
+    clock.RunUntilIdle();
+    EXPECT_TRUE(receiver->executed);
+    EXPECT_EQ(receiver->lastValue, 7);
+    EXPECT_TRUE(autoReceiver->executed);
+    EXPECT_EQ(autoReceiver->callCount, 1);
+    EXPECT_EQ(simulated->PendingTasks(), 0u); // Direct on the queue, not posted again
+}
+
+// Test pending queued deliveries are dropped on disconnection
+TEST_F(ConnectionTypesTest, DisconnectPurgesQueuedDeliveries) {
+    sigslot::signal<int> sig;
+    int calls = 0;
+
+    auto conn = sig.connect([&calls](int) { ++calls; },
+                            sigslot::connection_type::queued_connection, simulated.get());
+    sig.connect([&calls](int) { ++calls; },
+                sigslot::connection_type::queued_connection, simulated.get());
+
+    for (int i = 0; i < 100; ++i) {
+        sig(i);
+    }
+    EXPECT_EQ(simulated->PendingTasks(), 200u);
+
+    // one connection at a time, then in bulk
+    EXPECT_EQ(simulated->PurgeTasks(&calls), 0u);
+    conn.disconnect();
+    EXPECT_EQ(simulated->PendingTasks(), 100u);
+    sig.disconnect_all();
+    EXPECT_EQ(simulated->PendingTasks(), 0u);
+    clock.RunUntilIdle();
+    EXPECT_EQ(calls, 0);
+}
+
+// Test the deliveries still pending are purged once earlier ones ran
+TEST_F(ConnectionTypesTest, DisconnectPurgesPendingOnly) {
+    sigslot::signal<int> sig;
+    int calls = 0;
+
+    auto conn = sig.connect([&calls](int) { ++calls; },
+                            sigslot::connection_type::queued_connection, simulated.get());
+    auto debounced = sig.connect_limited(sigslot::rate_limit::debounce(std::chrono::milliseconds(50)),
+                                         [&calls](int) { ++calls; },
+                                         sigslot::connection_type::queued_connection, simulated.get());
+    sig.connect([&calls](int) { ++calls; },
+                sigslot::connection_type::queued_connection, simulated.get());
+
+    sig(1);
+    sig(2);
+    clock.RunUntilIdle();
+    EXPECT_EQ(calls, 4);
+    clock.AdvanceTime(std::chrono::milliseconds(50));
+    EXPECT_EQ(calls, 5);
+
+    sig(3);
+    EXPECT_EQ(simulated->PendingTasks(), 2u);   // the debounce timer is not counted
+    conn.disconnect();
+    debounced.disconnect();
+    EXPECT_EQ(simulated->PendingTasks(), 1u);
+    sig.disconnect_all();
+    EXPECT_EQ(simulated->PendingTasks(), 0u);
+    clock.AdvanceTime(std::chrono::milliseconds(50));
+    EXPECT_EQ(calls, 5);
+}
+
+// Test tracked slots share a single pin of their object per emission
+TEST_F(SignalSlotTest, TrackedSlotsPinning) {
+    sigslot::signal<int> sig;
+    auto receiver = std::make_shared<TestReceiver>();
+    std::weak_ptr<TestReceiver> weak = receiver;
+    std::vector<long> useCounts;
+
+    for (int i = 0; i < 4; ++i) {
+        sig.connect(receiver, [&useCounts, weak](int) { useCounts.push_back(weak.use_count()); });
+    }
+    sig.connect(receiver, &TestReceiver::onSingleParam);
+
+    sig(1);
+    EXPECT_EQ(useCounts, (std::vector<long>{2, 2, 2, 2})); // owner + one pin
+    EXPECT_EQ(receiver->lastValue, 1);
+    EXPECT_EQ(weak.use_count(), 1); // released after the emission
+
+    // Expired objects disconnect their slots
+    receiver.reset();
+    useCounts.clear();
+    sig(2);
+    EXPECT_TRUE(useCounts.empty());
+    EXPECT_EQ(sig.slot_count(), 0u);
+
+    // Signals without tracked slots do not set up pins
+    sigslot::signal<int> plain;
+    bool pinned = true;
+    plain.connect([&pinned](int) { pinned = sigslot::detail::tracked_pins::current() != nullptr; });
+    plain(3);
+    EXPECT_FALSE(pinned);
+}
+
+// Test tracked slots of aliasing pointers sharing an owner call their own object
+TEST_F(SignalSlotTest, TrackedSlotsAliasing) {
+    struct Pair {
+        TestReceiver first;
+        TestReceiver second;
+    };
+
+    sigslot::signal<int> sig;
+    auto owner = std::make_shared<Pair>();
+    std::shared_ptr<TestReceiver> first(owner, &owner->first);
+    std::shared_ptr<TestReceiver> second(owner, &owner->second);
+    sig.connect(first, &TestReceiver::onSingleParam);
+    sig.connect(second, [&owner](int value) { owner->second.onMultiParam(value, "second"); });
+    sig.connect(second, &TestReceiver::onSingleParam);
+
+    sig(5);
+    EXPECT_EQ(owner->first.lastValue, 5);
+    EXPECT_TRUE(owner->first.singleParamCalled);
+    EXPECT_FALSE(owner->first.multiParamCalled);
+    EXPECT_TRUE(owner->second.singleParamCalled);
+    EXPECT_TRUE(owner->second.multiParamCalled);
+    EXPECT_EQ(owner->second.lastValue, 5);
+}
+
+// Test observers only track their live connections
+TEST_F(SignalSlotTest, ObserverConnectionTracking) {
+    struct Observer : sigslot::observer {
+        using sigslot::observer::connection_count;
+        using sigslot::observer::disconnect_all;
+        void onValue(int v) { sum += v; }
+        int sum = 0;
+    };
+
+    sigslot::signal<int> sig;
+    auto observer = std::make_unique<Observer>();
+
+    // Connections dropped elsewhere are pruned from the observer
+    for (int i = 0; i < 1000; ++i) {
+        auto conn = sig.connect(observer.get(), &Observer::onValue);
+        EXPECT_EQ(observer->connection_count(), 1u);
+        conn.disconnect();
+    }
+    EXPECT_EQ(observer->connection_count(), 0u);
+
+    sig.connect(observer.get(), &Observer::onValue);
+    sig.connect(observer.get(), &Observer::onValue);
+    sig.disconnect_all();
+    EXPECT_EQ(observer->connection_count(), 0u);
+
+    sig.connect(observer.get(), &Observer::onValue);
+    sig.connect(observer.get(), &Observer::onValue);
+    sig(1);
+    EXPECT_EQ(observer->sum, 2);
+    observer->disconnect_all();
+    EXPECT_EQ(observer->connection_count(), 0u);
+    EXPECT_EQ(sig.slot_count(), 0u);
+
+    // Destroying the observer disconnects its slots
+    sig.connect(observer.get(), &Observer::onValue);
+    observer.reset();
+    EXPECT_EQ(sig.slot_count(), 0u);
+    sig(1);
+}
+
+// Test keyed connections keep per-key order across a queue group
+TEST_F(ConnectionTypesTest, KeyedQueueGroup) {
+    auto *group = TQMgr->createGroup("keyed", 4);
+    ASSERT_EQ(TQG("keyed"), group);
+
+    sigslot::signal<int, int> sig;
+    std::mutex mutex;
+    std::map<int, std::vector<int>> sequences;
+    std::map<int, std::set<std::thread::id>> threads;
+    std::atomic<int> calls{0};
+
+    sig.connect_keyed(group, [](int device, int) { return device; },
+                      [&](int device, int seq) {
+                          std::lock_guard<std::mutex> lock(mutex);
+                          sequences[device].push_back(seq);
+                          threads[device].insert(std::this_thread::get_id());
+                          ++calls;
+                      });
+
+    for (int seq = 0; seq < 100; ++seq) {
+        for (int device = 0; device < 8; ++device) {
+            sig(device, seq);
+        }
+    }
+    for (int i = 0; i < 100 && calls < 800; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(calls, 800);
+    std::set<std::thread::id> used;
+    for (int device = 0; device < 8; ++device) {
+        EXPECT_EQ(sequences[device].size(), 100u);
+        EXPECT_TRUE(std::is_sorted(sequences[device].begin(), sequences[device].end()));
+        EXPECT_EQ(threads[device].size(), 1u);
+        used.insert(*threads[device].begin());
+    }
+    EXPECT_GT(used.size(), 1u);
+}
+
+// Test balanced connections spread deliveries over their queues
+TEST_F(ConnectionTypesTest, BalancedQueueSet) {
+    auto *group = TQMgr->createGroup("balanced", 3);
+
+    for (auto policy : {sigslot::balance_policy::round_robin, sigslot::balance_policy::two_choices}) {
+        sigslot::signal<int> sig;
+        std::mutex mutex;
+        std::map<std::thread::id, int> perThread;
+        std::atomic<int> calls{0};
+
+        sig.connect_balanced(group, policy, [&](int) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            std::lock_guard<std::mutex> lock(mutex);
+            ++perThread[std::this_thread::get_id()];
+            ++calls;
+        });
+
+        for (int i = 0; i < 300; ++i) {
+            sig(i);
+        }
+        for (int i = 0; i < 200 && calls < 300; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        ASSERT_EQ(calls, 300);
+        EXPECT_EQ(perThread.size(), 3u);
+        if (policy == sigslot::balance_policy::round_robin) {
+            for (const auto& entry : perThread) {
+                EXPECT_EQ(entry.second, 100);
+            }
+        }
+    }
+}
+
+// Test spsc connections keep the producer order, through overflows and thread changes
+TEST_F(ConnectionTypesTest, SpscConnection) {
+    sigslot::signal<int> sig;
+    std::vector<int> received;
+    std::atomic<int> calls{0};
+
+    sig.connect_spsc(4, [&](int v) { received.push_back(v); ++calls; },
+                     sigslot::connection_type::queued_connection, TQ("worker"));
+
+    // overflow the ring while the queue is busy
+    std::promise<void> gate;
+    auto blocked = gate.get_future().share();
+    TQ("worker")->PostTask([blocked]() { blocked.wait(); });
+    for (int i = 0; i < 100; ++i) {
+        sig(i);
+    }
+    gate.set_value();
+
+    for (int i = 100; i < 1000; ++i) {
+        sig(i);
+    }
+
+    // another emitting thread falls back to the regular path
+    std::thread([&sig]() { sig(1000); }).join();
+
+    for (int i = 0; i < 100 && calls < 1001; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(calls, 1001);
+    std::vector<int> expected(1001);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(received, expected);
+}
+
+// Test spilling connections overflow to disk and deliver everything in order
+TEST_F(ConnectionTypesTest, SpillingConnection) {
+    core::SimulatedClock clock;
+    auto queue = core::TaskQueue::CreateSimulated("spill", clock);
+    const std::string path = ::testing::TempDir() + "sigslot_spill_test";
+    std::vector<int> received;
+
+    {
+        sigslot::signal<int, std::string> sig;
+        sigslot::spill_options options;
+        options.path = path;
+        options.max_pending = 10;
+        options.chunk_size = 4096;
+        sig.connect_spilling(options, [&received](int v, const std::string& s) {
+            EXPECT_EQ(s, std::to_string(v));
+            received.push_back(v);
+        }, sigslot::connection_type::queued_connection, queue.get());
+
+        for (int i = 0; i < 1000; ++i) {
+            sig(i, std::to_string(i));
+        }
+        // the queue holds the budget and one drain task, the rest is on disk
+        EXPECT_EQ(queue->PendingTasks(), 11u);
+        EXPECT_NE(core::MappedFile::Open(path + ".0"), nullptr);
+
+        clock.RunUntilIdle();
+        std::vector<int> expected(1000);
+        std::iota(expected.begin(), expected.end(), 0);
+        EXPECT_EQ(received, expected);
+
+        // back under budget, deliveries are posted again
+        sig(1000, "1000");
+        EXPECT_EQ(queue->PendingTasks(), 1u);
+        clock.RunUntilIdle();
+        EXPECT_EQ(received.size(), 1001u);
+    }
+
+    // spill files go away with the connection
+    EXPECT_EQ(core::MappedFile::Open(path + ".0"), nullptr);
+}
+
+// Test deliveries failing to spill behind spilled ones are dropped, not reordered
+TEST_F(ConnectionTypesTest, SpillingConnectionWriteFailure) {
+    core::SimulatedClock clock;
+    auto queue = core::TaskQueue::CreateSimulated("spill_failure", clock);
+    const std::filesystem::path dir = ::testing::TempDir() + "sigslot_spill_failure";
+    const std::filesystem::path moved = ::testing::TempDir() + "sigslot_spill_failure_moved";
+    std::filesystem::remove_all(moved);
+    std::filesystem::create_directories(dir);
+    std::atomic<std::uint64_t> dropped{0};
+    std::vector<int> received;
+
+    {
+        sigslot::signal<int> sig;
+        sigslot::spill_options options;
+        options.path = (dir / "spill").string();
+        options.max_pending = 1;
+        options.chunk_size = 64;
+        options.dropped = &dropped;
+        sig.connect_spilling(options, [&received](int v) {
+            received.push_back(v);
+        }, sigslot::connection_type::queued_connection, queue.get());
+
+        sig(0);
+        sig(1);
+        // further chunks can no longer be created
+        std::filesystem::rename(dir, moved);
+        for (int i = 2; i < 100; ++i) {
+            sig(i);
+        }
+        clock.RunUntilIdle();
+        EXPECT_GT(dropped.load(), 0u);
+        EXPECT_EQ(received.size() + dropped.load(), 100u);
+        EXPECT_TRUE(std::is_sorted(received.begin(), received.end()));
+
+        // nothing is spilled anymore, deliveries are posted again
+        sig(100);
+        clock.RunUntilIdle();
+        EXPECT_EQ(received.back(), 100);
+    }
+    std::filesystem::remove_all(moved);
+}
+
+// Test rate limited connections against a simulated clock, without sleeping
+TEST_F(ConnectionTypesTest, RateLimitedSimulatedClock) {
+    core::SimulatedClock clock;
+    auto queue = core::TaskQueue::CreateSimulated("simulated", clock);
+    sigslot::signal<int> sig;
+    std::vector<int> leading, debounced;
+
+    sig.connect_limited(sigslot::rate_limit::throttle(std::chrono::milliseconds(100)),
+                        [&leading](int v) { leading.push_back(v); },
+                        sigslot::connection_type::direct_connection, queue.get());
+    sig.connect_limited(sigslot::rate_limit::debounce(std::chrono::milliseconds(50)),
+                        [&debounced](int v) { debounced.push_back(v); },
+                        sigslot::connection_type::queued_connection, queue.get());
+
+    // bursts of emissions 30 ms apart, then a pause of 60 ms
+    for (int i = 1; i <= 9; ++i) {
+        sig(i);
+        clock.AdvanceTime(std::chrono::milliseconds(i % 3 == 0 ? 60 : 30));
+    }
+    clock.AdvanceTime(std::chrono::milliseconds(100));
+
+    EXPECT_EQ(leading, (std::vector<int>{1, 4, 7}));
+    EXPECT_EQ(debounced, (std::vector<int>{3, 6, 9}));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../signal-slot/signal_slot_api.hpp"
+
+namespace {
+
+struct BusySlot {
+    void operator()(int) const {
+        // burn some CPU time
+        const auto end = core::ThreadCpuTime() + std::chrono::microseconds(500);
+        volatile unsigned spin = 0;
+        while (core::ThreadCpuTime() < end) {
+            spin = spin + 1;
+        }
+    }
+};
+
+struct SleepySlot {
+    void operator()(int) const {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+};
+
+const sigslot::slot_cpu_stats* Find(const std::vector<sigslot::slot_cpu_stats>& stats,
+                                    const std::string& callable, const std::string& queue) {
+    for (auto& s : stats) {
+        if (s.callable.find(callable) != std::string::npos && s.queue == queue) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+#if defined(CORE_POSIX)
+
+class SlotProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sigslot::slot_profiler::enable();
+        sigslot::slot_profiler::reset();
+    }
+
+    void TearDown() override {
+        sigslot::slot_profiler::disable();
+    }
+};
+
+// Test direct and queued slots are accounted to their callable and queue
+TEST_F(SlotProfilerTest, CpuTime) {
+    auto queue = core::TaskQueue::Create("profiled");
+
+    sigslot::signal<int> sig;
+    sig.connect(BusySlot{});
+    sig.connect(SleepySlot{}, sigslot::connection_type::queued_connection, queue.get());
+    for (int i = 0; i < 4; ++i) {
+        sig(i);
+    }
+    std::promise<void> done;
+    queue->PostTask([&done]() { done.set_value(); });
+    done.get_future().wait();
+
+    auto stats = sigslot::slot_profiler::snapshot();
+    auto* busy = Find(stats, "BusySlot", "");
+    ASSERT_NE(busy, nullptr);
+    EXPECT_EQ(busy->signal, &sig);
+    EXPECT_EQ(busy->type, sigslot::connection_type::direct_connection);
+    EXPECT_EQ(busy->calls, 4u);
+    EXPECT_GE(busy->cpu, std::chrono::milliseconds(2));
+
+    // sleeping takes wall time, not CPU time
+    auto* sleepy = Find(stats, "SleepySlot", "profiled");
+    ASSERT_NE(sleepy, nullptr);
+    EXPECT_EQ(sleepy->calls, 4u);
+    EXPECT_GE(sleepy->wall, std::chrono::milliseconds(8));
+    EXPECT_LT(sleepy->cpu, sleepy->wall / 2);
+
+    // the busiest slot comes first
+    EXPECT_EQ(&stats.front(), busy);
+    EXPECT_NE(sigslot::slot_profiler::report(stats).find("BusySlot"), std::string::npos);
+}
+
+// Test tables of exited threads are kept and merged
+TEST_F(SlotProfilerTest, MergeThreads) {
+    sigslot::signal<int> sig;
+    sig.connect(BusySlot{});
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&sig]() {
+            sig(0);
+            sig(1);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    sig(2);
+
+    auto stats = sigslot::slot_profiler::by_callable();
+    auto* busy = Find(stats, "BusySlot", "");
+    ASSERT_NE(busy, nullptr);
+    EXPECT_EQ(busy->calls, 7u);
+
+    sigslot::slot_profiler::reset();
+    EXPECT_EQ(Find(sigslot::slot_profiler::snapshot(), "BusySlot", ""), nullptr);
+}
+
+#endif
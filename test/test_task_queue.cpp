@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+#include "./signal-slot/core/task_queue.hpp"
+#include "./signal-slot/core/task_queue_group.hpp"
+#include "./signal-slot/core/task_queue_simulated.hpp"
+#include "./signal-slot/core/unix_socket.hpp"
+
+class TaskQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        queue = core::TaskQueue::Create("test");
+    }
+
+    // block the queue until the returned promise is set
+    std::shared_ptr<std::promise<void>> blockQueue() {
+        auto gate = std::make_shared<std::promise<void>>();
+        auto future = gate->get_future().share();
+        queue->PostTask([future]() { future.wait(); });
+        return gate;
+    }
+
+    void drain() {
+        std::promise<void> done;
+        queue->PostTask([&done]() { done.set_value(); });
+        done.get_future().wait();
+    }
+
+    std::unique_ptr<core::TaskQueue> queue;
+};
+
+// Test tasks can be dropped by tag before they run
+TEST_F(TaskQueueTest, PurgeTasksByTag) {
+    int ownerA = 0, ownerB = 0;
+    std::atomic<int> runA{0}, runB{0};
+
+    auto gate = blockQueue();
+    for (int i = 0; i < 10; ++i) {
+        auto a = core::ToQueuedTask([&runA]() { ++runA; });
+        a->set_tag(&ownerA);
+        queue->PostTask(std::move(a));
+
+        auto b = core::ToQueuedTask([&runB]() { ++runB; });
+        b->set_tag(&ownerB);
+        queue->PostTask(std::move(b));
+    }
+    auto delayed = core::ToQueuedTask([&runA]() { ++runA; });
+    delayed->set_tag(&ownerA);
+    queue->PostDelayedTask(std::move(delayed), std::chrono::milliseconds(10));
+
+    EXPECT_EQ(queue->PurgeTasks(&ownerA), 11u);
+    gate->set_value();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    drain();
+
+    EXPECT_EQ(runA, 0);
+    EXPECT_EQ(runB, 10);
+    EXPECT_EQ(queue->PurgeTasks(&ownerB), 0u);
+}
+
+// Test keys map to a stable queue of a group
+TEST_F(TaskQueueTest, GroupKeyAffinity) {
+    core::TaskQueueGroup group("group", 4);
+    ASSERT_EQ(group.Size(), 4u);
+
+    std::set<core::TaskQueue*> used;
+    for (uint64_t key = 0; key < 64; ++key) {
+        auto *q = group.ForKey(key);
+        EXPECT_EQ(q, group.ForKey(key));
+        used.insert(q);
+    }
+    EXPECT_EQ(used.size(), 4u);
+
+    // keys only move to the new queue when the group grows
+    core::TaskQueueGroup larger("larger", 5);
+    for (uint64_t key = 0; key < 64; ++key) {
+        size_t before = 0, after = 0;
+        while (group.At(before) != group.ForKey(key)) ++before;
+        while (larger.At(after) != larger.ForKey(key)) ++after;
+        EXPECT_TRUE(after == before || after == 4u);
+    }
+}
+
+// Test the pending task count follows posts, runs and purges
+TEST_F(TaskQueueTest, PendingTasks) {
+    EXPECT_EQ(queue->PendingTasks(), 0u);
+
+    int owner = 0;
+    auto gate = blockQueue();
+    for (int i = 0; i < 5; ++i) {
+        auto task = core::ToQueuedTask([]() {});
+        task->set_tag(&owner);
+        queue->PostTask(std::move(task));
+    }
+    queue->PostDelayedTask([]() {}, std::chrono::milliseconds(1000));
+    EXPECT_EQ(queue->PendingTasks(), 6u); // the blocker included
+
+    EXPECT_EQ(queue->PurgeTasks(&owner), 5u);
+    EXPECT_EQ(queue->PendingTasks(), 1u);
+
+    gate->set_value();
+    drain();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(queue->PendingTasks(), 0u);
+}
+
+// Test the sharded backend keeps the order of each producer
+TEST_F(TaskQueueTest, ShardedPerProducerOrder) {
+    auto sharded = core::TaskQueue::CreateSharded("sharded", 4);
+    constexpr int kProducers = 8;
+    constexpr int kTasks = 1000;
+
+    std::vector<std::vector<int>> received(kProducers);
+    std::atomic<int> runs{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < kTasks; ++i) {
+                sharded->PostTask([&received, &runs, p, i]() {
+                    received[p].push_back(i);
+                    ++runs;
+                });
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    std::promise<void> done;
+    sharded->PostDelayedTask([&done]() { done.set_value(); }, std::chrono::milliseconds(10));
+    done.get_future().wait();
+    for (int i = 0; i < 200 && runs < kProducers * kTasks; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    ASSERT_EQ(runs, kProducers * kTasks);
+    for (const auto& seq : received) {
+        ASSERT_EQ(seq.size(), static_cast<size_t>(kTasks));
+        EXPECT_TRUE(std::is_sorted(seq.begin(), seq.end()));
+    }
+
+    // pending tasks can still be purged
+    int owner = 0;
+    std::promise<void> gate;
+    auto blocked = gate.get_future().share();
+    sharded->PostTask([blocked]() { blocked.wait(); });
+    for (int i = 0; i < 10; ++i) {
+        auto task = core::ToQueuedTask([&runs]() { ++runs; });
+        task->set_tag(&owner);
+        sharded->PostTask(std::move(task));
+    }
+    EXPECT_EQ(sharded->PurgeTasks(&owner), 10u);
+    gate.set_value();
+}
+
+// Test simulated queues run due tasks in time order when the clock advances
+TEST_F(TaskQueueTest, SimulatedClock) {
+    core::SimulatedClock clock;
+    auto first = core::TaskQueue::CreateSimulated("first", clock);
+    auto second = core::TaskQueue::CreateSimulated("second", clock);
+    const auto start = clock.Now();
+
+    std::vector<std::pair<int, std::chrono::milliseconds>> runs;
+    auto record = [&](int id) {
+        return [&runs, &clock, start, id]() {
+            runs.emplace_back(id, std::chrono::duration_cast<std::chrono::milliseconds>(clock.Now() - start));
+        };
+    };
+
+    first->PostDelayedTask(record(3), std::chrono::milliseconds(300));
+    second->PostDelayedTask(record(2), std::chrono::milliseconds(200));
+    first->PostTask(record(1));
+    second->PostDelayedTask([&]() {
+        EXPECT_TRUE(second->IsCurrent());
+        // posted from a task, due within the same advance
+        first->PostDelayedTask(record(4), std::chrono::milliseconds(50));
+    }, std::chrono::milliseconds(250));
+    first->PostDelayedTask(record(5), std::chrono::seconds(10));
+
+    // nothing runs until the clock is driven
+    EXPECT_TRUE(runs.empty());
+    EXPECT_EQ(first->PendingTasks(), 1u);
+
+    clock.AdvanceTime(std::chrono::milliseconds(400));
+    using ms = std::chrono::milliseconds;
+    EXPECT_EQ(runs, (std::vector<std::pair<int, ms>>{{1, ms(0)}, {2, ms(200)}, {3, ms(300)}, {4, ms(300)}}));
+    EXPECT_EQ(clock.Now() - start, ms(400));
+
+    // an hour of simulated time takes no real time
+    const auto real = std::chrono::steady_clock::now();
+    clock.AdvanceTime(std::chrono::hours(1));
+    EXPECT_LT(std::chrono::steady_clock::now() - real, std::chrono::seconds(1));
+    ASSERT_EQ(runs.size(), 5u);
+    EXPECT_EQ(runs[4], std::make_pair(5, ms(10000)));
+}
+
+#if defined(__linux__)
+// Test the epoll backend runs tasks and readable callbacks on its thread
+TEST_F(TaskQueueTest, EpollWatchReadable) {
+    auto epoll = core::TaskQueue::CreateEpoll("epoll");
+    ASSERT_NE(epoll, nullptr);
+
+    int fds[2];
+    ASSERT_TRUE(core::UnixSocketPair(fds));
+    core::SetNonBlocking(fds[1]);
+
+    std::atomic<int> bytes{0};
+    std::atomic<int> tasks{0};
+    ASSERT_TRUE(epoll->WatchReadable(fds[1], [&bytes, &fds]() {
+        char buffer[16];
+        long n;
+        while ((n = core::ReadSome(fds[1], buffer, sizeof(buffer))) > 0) {
+            bytes += static_cast<int>(n);
+        }
+    }));
+    EXPECT_FALSE(epoll->WatchReadable(fds[1], []() {}));
+
+    epoll->PostDelayedTask([&tasks]() { ++tasks; }, std::chrono::milliseconds(10));
+    epoll->PostTask([&tasks]() { ++tasks; });
+    const char data[] = "hello";
+    core::IoSlice slice{data, 5};
+    ASSERT_TRUE(core::WriteVectored(fds[0], &slice, 1));
+
+    for (int i = 0; i < 100 && (bytes < 5 || tasks < 2); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(bytes, 5);
+    EXPECT_EQ(tasks, 2);
+
+    std::promise<void> done;
+    epoll->PostTask([&]() {
+        epoll->UnwatchReadable(fds[1]);
+        done.set_value();
+    });
+    done.get_future().wait();
+    core::CloseSocket(fds[0]);
+    core::CloseSocket(fds[1]);
+}
+#endif
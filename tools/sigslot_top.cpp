@@ -0,0 +1,143 @@
+// sigslot_top: live view of the task queues and instrumented signals of a
+// process that enabled core::Metrics, read from its stats region without
+// any cooperation from it.
+//
+//   sigslot_top <pid | region name> [--once] [--openmetrics] [--interval ms]
+//
+// Rates are computed between two refreshes, durations are the upper bounds of
+// the histogram buckets holding the percentile.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../signal-slot/core/metrics.hpp"
+#include "../signal-slot/core/shared_memory.hpp"
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr, "usage: sigslot_top <pid | region name> [--once] [--openmetrics] [--interval ms]\n");
+}
+
+std::string RegionOf(const std::string& target) {
+    const bool pid = !target.empty() && target.find_first_not_of("0123456789") == std::string::npos;
+    return pid ? core::Metrics::DefaultRegionName(std::strtoull(target.c_str(), nullptr, 10)) : target;
+}
+
+std::string Duration(std::chrono::microseconds us) {
+    char buffer[32];
+    if (us.count() >= 1000000) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fs", us.count() / 1e6);
+    } else if (us.count() >= 1000) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fms", us.count() / 1e3);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%lldus", static_cast<long long>(us.count()));
+    }
+    return buffer;
+}
+
+using Counts = std::map<std::pair<int, std::string>, uint64_t>;
+
+double Rate(const Counts& previous, const core::MetricsSnapshot& e, double seconds) {
+    auto it = previous.find({static_cast<int>(e.kind), e.name});
+    if (it == previous.end() || seconds <= 0 || e.count < it->second) {
+        return 0;
+    }
+    return static_cast<double>(e.count - it->second) / seconds;
+}
+
+void Print(const std::string& region, const std::vector<core::MetricsSnapshot>& entries,
+           const Counts& previous, double seconds) {
+    std::printf("%s  %zu entries\n\n", region.c_str(), entries.size());
+    std::printf("%-32s %8s %12s %10s %9s %9s %9s %9s\n",
+                "QUEUE", "DEPTH", "TASKS", "TASKS/S", "WAIT p50", "WAIT p99", "RUN p50", "RUN p99");
+    for (auto& e : entries) {
+        if (e.kind != core::MetricsKind::kQueue) {
+            continue;
+        }
+        std::printf("%-32.32s %8llu %12llu %10.0f %9s %9s %9s %9s\n", e.name.c_str(),
+                    static_cast<unsigned long long>(e.depth), static_cast<unsigned long long>(e.count),
+                    Rate(previous, e, seconds),
+                    Duration(e.wait.Percentile(0.5)).c_str(), Duration(e.wait.Percentile(0.99)).c_str(),
+                    Duration(e.run.Percentile(0.5)).c_str(), Duration(e.run.Percentile(0.99)).c_str());
+    }
+    std::printf("\n%-32s %12s %10s %12s %10s %9s %9s\n",
+                "SIGNAL", "EMITS", "EMITS/S", "DELIVERIES", "DROPS", "EMIT p50", "EMIT p99");
+    for (auto& e : entries) {
+        if (e.kind != core::MetricsKind::kSignal) {
+            continue;
+        }
+        std::printf("%-32.32s %12llu %10.0f %12llu %10llu %9s %9s\n", e.name.c_str(),
+                    static_cast<unsigned long long>(e.count), Rate(previous, e, seconds),
+                    static_cast<unsigned long long>(e.deliveries), static_cast<unsigned long long>(e.drops),
+                    Duration(e.run.Percentile(0.5)).c_str(), Duration(e.run.Percentile(0.99)).c_str());
+    }
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string target;
+    bool once = false;
+    bool openmetrics = false;
+    int interval = 1000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--once") == 0) {
+            once = true;
+        } else if (std::strcmp(argv[i], "--openmetrics") == 0) {
+            openmetrics = true;
+        } else if (std::strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval = std::max(100, std::atoi(argv[++i]));
+        } else if (argv[i][0] != '-' && target.empty()) {
+            target = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (target.empty()) {
+        usage();
+        return 2;
+    }
+
+    const std::string region = RegionOf(target);
+    auto memory = core::SharedMemory::Open(region);
+    if (!memory) {
+        std::fprintf(stderr, "sigslot_top: no stats region %s\n", region.c_str());
+        return 1;
+    }
+
+    Counts previous;
+    auto last = std::chrono::steady_clock::now();
+    for (;;) {
+        const auto entries = core::Metrics::Read(memory->Data(), memory->Size());
+        const auto now = std::chrono::steady_clock::now();
+        if (openmetrics) {
+            std::fputs(core::Metrics::FormatOpenMetrics(entries).c_str(), stdout);
+            std::fflush(stdout);
+        } else {
+            if (!once) {
+                std::printf("\033[H\033[2J");
+            }
+            Print(region, entries, previous, std::chrono::duration<double>(now - last).count());
+        }
+        if (once) {
+            return 0;
+        }
+
+        previous.clear();
+        for (auto& e : entries) {
+            previous[{static_cast<int>(e.kind), e.name}] = e.count;
+        }
+        last = now;
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+    }
+}